@@ -0,0 +1,67 @@
+# Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+#
+# Records the order the packaged game opens its files in and writes it where UnrealPak picks it up when the project
+# is packaged (Build/WindowsNoEditor/FileOpenOrder/GameOpenOrder.log), so the pak is laid out in the order a real
+# playthrough reads it: the three maps, castle gate and stone wall textures, StoneGrinding cues, the BlankWall,
+# Ladder and RosemaryBush meshes, ...
+#
+# Needs a packaged Development build (-fileopenlog is compiled out of Shipping). Each run plays the tower hands-off
+# with -Autoplay; the runs are merged by keeping every file at the earliest position it was opened in any run.
+#
+#   powershell -File Build\Scripts\RecordFileOpenOrder.ps1 -StagedBuild C:\Packaged\WindowsNoEditor -Runs 3
+#
+# Then package Shipping as usual and commit the updated GameOpenOrder.log.
+
+param(
+	[Parameter(Mandatory = $true)]
+	[string]$StagedBuild,
+	[int]$Runs = 3,
+	[int]$AutoplayTimeout = 600
+)
+
+$ErrorActionPreference = "Stop"
+
+$ProjectName = "EscapeTheTower"
+$Platform = "WindowsNoEditor"
+$ProjectRoot = Resolve-Path (Join-Path $PSScriptRoot "..\..")
+$GameExe = Join-Path $StagedBuild "$ProjectName.exe"
+$RecordedLog = Join-Path $StagedBuild "$ProjectName\Build\$Platform\FileOpenOrder\GameOpenOrder.log"
+$OutputDir = Join-Path $ProjectRoot "Build\$Platform\FileOpenOrder"
+$RunsDir = Join-Path $OutputDir "Runs"
+
+if (-not (Test-Path $GameExe)) {throw "$GameExe not found, package a Development build first."}
+New-Item -ItemType Directory -Force -Path $RunsDir | Out-Null
+
+# Earliest position each file was opened at, over every run.
+$FirstOpen = @{}
+
+for ($Run = 1; $Run -le $Runs; $Run++)
+{
+	Remove-Item $RecordedLog -ErrorAction SilentlyContinue
+	Write-Host "Recording run $Run of $Runs..."
+
+	# The normal map flow with sound and rendering on, so cues and textures load when a player would load them.
+	$Game = Start-Process -FilePath $GameExe -ArgumentList "-fileopenlog", "-Autoplay=1", "-AutoplayTimeout=$AutoplayTimeout", "-unattended" -PassThru
+	$Game.WaitForExit()
+
+	if (-not (Test-Path $RecordedLog)) {throw "Run $Run did not write $RecordedLog."}
+	Copy-Item $RecordedLog (Join-Path $RunsDir "GameOpenOrder_$Run.log") -Force
+
+	# Lines look like: "../../../EscapeTheTower/Content/Maps/LoadingScreenLevel.umap" 3
+	foreach ($Line in Get-Content $RecordedLog)
+	{
+		if ($Line -notmatch '^\s*"(.+)"\s+(\d+)\s*$') {continue}
+		$File = $Matches[1]
+		$Order = [int]$Matches[2]
+		if (-not $FirstOpen.ContainsKey($File) -or $Order -lt $FirstOpen[$File]) {$FirstOpen[$File] = $Order}
+	}
+}
+
+$OrderFile = Join-Path $OutputDir "GameOpenOrder.log"
+$Index = 1
+$FirstOpen.GetEnumerator() | Sort-Object Value, Name | ForEach-Object {
+	"`"$($_.Name)`" $Index"
+	$Index++
+} | Set-Content -Encoding Ascii $OrderFile
+
+Write-Host "Wrote $($FirstOpen.Count) files to $OrderFile."
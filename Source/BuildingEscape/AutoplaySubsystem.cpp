@@ -0,0 +1,148 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "AutoplaySubsystem.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeSettings.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "TowerSaveSubsystem.h"
+#include "UObject/UObjectGlobals.h"
+
+void UAutoplaySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FParse::Value(FCommandLine::Get(), TEXT("Autoplay="), NumRuns);
+	FParse::Value(FCommandLine::Get(), TEXT("AutoplayTimeout="), RunTimeout);
+	if (!IsActive()) {return;}
+
+	// Every run wipes the tower's progress, so runs save to their own slot and leave the player's save alone. The
+	// player's progress is already in memory by now, so drop it too.
+	if (UTowerSaveSubsystem* TowerSave = Cast<UTowerSaveSubsystem>(Collection.InitializeDependency(UTowerSaveSubsystem::StaticClass())))
+	{
+		TowerSave->SetSaveSlotName(TEXT("TowerProgress_Autoplay"));
+		TowerSave->ResetProgress();
+	}
+
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UAutoplaySubsystem::OnPostLoadMap);
+	UE_LOG(LogAutoplay, Log, TEXT("Autoplay enabled: %d runs, %.0f s timeout per run."), NumRuns, RunTimeout);
+}
+
+void UAutoplaySubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+
+	Super::Deinitialize();
+}
+
+UAutoplaySubsystem* UAutoplaySubsystem::Get(const UObject* WorldContextObject)
+{
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+	return GameInstance ? GameInstance->GetSubsystem<UAutoplaySubsystem>() : nullptr;
+}
+
+bool UAutoplaySubsystem::ShouldAutoplay(const UWorld* World) const
+{
+	if (!IsActive() || !World || bIsRunning || RunsStarted >= NumRuns) {return false;}
+
+	const FString MainLevelPackageName = GetDefault<UBuildingEscapeSettings>()->MainLevel.GetLongPackageName();
+	return World->GetOutermost()->GetName() == MainLevelPackageName;
+}
+
+void UAutoplaySubsystem::StartRun(const UWorld* World)
+{
+	bIsRunning = true;
+	RunsStarted++;
+	RunStartTime = FPlatformTime::Seconds();
+	UE_LOG(LogAutoplay, Log, TEXT("Autoplay run %d/%d started in %s."), RunsStarted, NumRuns, *World->GetMapName());
+}
+
+void UAutoplaySubsystem::EndRun(UWorld* World, bool bSucceeded, const FString& Reason)
+{
+	if (!bIsRunning) {return;}
+	bIsRunning = false;
+
+	const double RunDuration = FPlatformTime::Seconds() - RunStartTime;
+	if (bSucceeded)
+	{
+		RunsSucceeded++;
+		SucceededRunDurations.Add(RunDuration);
+		UE_LOG(LogAutoplay, Log, TEXT("Autoplay run %d/%d in %s succeeded in %.2f s (%.2f s game time)."),
+			RunsStarted, NumRuns, *World->GetMapName(), RunDuration, World->GetTimeSeconds());
+	}
+	else
+	{
+		UE_LOG(LogAutoplay, Warning, TEXT("Autoplay run %d/%d in %s failed after %.2f s: %s"), RunsStarted, NumRuns, *World->GetMapName(), RunDuration, *Reason);
+	}
+	OnRunEnded.Broadcast(this, bSucceeded);
+
+	// After a win the win component opens the win screen, which brings us back here through OnPostLoadMap.
+	if (!bSucceeded && !bIsHostedSession)
+	{
+		OpenNextRun(World);
+	}
+}
+
+void UAutoplaySubsystem::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	if (!LoadedWorld || LoadedWorld->GetGameInstance() != GetGameInstance() || bIsRunning || bIsHostedSession) {return;}
+
+	// The game mode starts runs in the main level; every other level is skipped.
+	if (ShouldAutoplay(LoadedWorld)) {return;}
+	OpenNextRun(LoadedWorld);
+}
+
+void UAutoplaySubsystem::OpenNextRun(UWorld* World)
+{
+	if (!HasRunsLeft())
+	{
+		FinishRuns();
+		return;
+	}
+
+	// Every run starts from a fresh tower.
+	if (UTowerSaveSubsystem* TowerSave = GetGameInstance()->GetSubsystem<UTowerSaveSubsystem>())
+	{
+		TowerSave->ResetProgress();
+	}
+	UGameplayStatics::OpenLevel(World, FName(*GetDefault<UBuildingEscapeSettings>()->MainLevel.GetLongPackageName()), false);
+}
+
+void UAutoplaySubsystem::FinishRuns()
+{
+	LogSummary();
+	OnFinished.Broadcast(this);
+
+	if (bExitWhenFinished && !bIsHostedSession)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void UAutoplaySubsystem::LogSummary() const
+{
+	if (SucceededRunDurations.Num() == 0)
+	{
+		UE_LOG(LogAutoplay, Warning, TEXT("Autoplay finished in %s: 0/%d runs succeeded."), *GetGameInstance()->GetName(), RunsStarted);
+		return;
+	}
+
+	double MinDuration = SucceededRunDurations[0];
+	double MaxDuration = SucceededRunDurations[0];
+	double TotalDuration = 0.0;
+	for (double RunDuration : SucceededRunDurations)
+	{
+		MinDuration = FMath::Min(MinDuration, RunDuration);
+		MaxDuration = FMath::Max(MaxDuration, RunDuration);
+		TotalDuration += RunDuration;
+	}
+
+	UE_LOG(LogAutoplay, Log, TEXT("Autoplay finished in %s: %d/%d runs succeeded, min %.2f s, avg %.2f s, max %.2f s."),
+		*GetGameInstance()->GetName(), RunsSucceeded, RunsStarted, MinDuration, TotalDuration / SucceededRunDurations.Num(), MaxDuration);
+}
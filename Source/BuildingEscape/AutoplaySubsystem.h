@@ -0,0 +1,69 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "AutoplaySubsystem.generated.h"
+
+class UAutoplaySubsystem;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnAutoplayRunEnded, UAutoplaySubsystem*, bool /*bSucceeded*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnAutoplayFinished, UAutoplaySubsystem*);
+
+// Runs the tower hands-off for soak and load testing when the game is started with -Autoplay=N (usually together
+// with -nullrhi). Every time the main level opens, the game mode hands the player's character to an
+// AAutoplayerController; any other level (loading screen, win screen) is skipped straight back to the main level
+// until N runs have finished, then the process exits. Each run's result and duration is logged to LogAutoplay.
+UCLASS()
+class BUILDINGESCAPE_API UAutoplaySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Return the autoplay subsystem of WorldContextObject's game instance, if there is one.
+	static UAutoplaySubsystem* Get(const UObject* WorldContextObject);
+
+	bool IsActive() const {return NumRuns > 0;}
+	bool HasRunsLeft() const {return RunsStarted < NumRuns;}
+
+	// Sessions of a USimulationHostSubsystem are restarted by the host, which also decides when to exit.
+	void SetHostedSession(bool bNewIsHostedSession) {bIsHostedSession = bNewIsHostedSession;}
+	bool IsHostedSession() const {return bIsHostedSession;}
+	void SetExitWhenFinished(bool bNewExitWhenFinished) {bExitWhenFinished = bNewExitWhenFinished;}
+
+	// True if World is the main level and a run should start in it.
+	bool ShouldAutoplay(const UWorld* World) const;
+
+	// Seconds a run may take before it is abandoned.
+	float GetRunTimeout() const {return RunTimeout;}
+
+	void StartRun(const UWorld* World);
+	void EndRun(UWorld* World, bool bSucceeded, const FString& Reason);
+
+	// Log the summary and exit, unless something else decides when to exit.
+	void FinishRuns();
+
+	FOnAutoplayRunEnded OnRunEnded;
+	FOnAutoplayFinished OnFinished;
+
+private:
+	void OnPostLoadMap(UWorld* LoadedWorld);
+	void OpenNextRun(UWorld* World);
+	void LogSummary() const;
+
+	// Member Variables
+	int32 NumRuns = 0;
+	int32 RunsStarted = 0;
+	int32 RunsSucceeded = 0;
+	bool bIsRunning = false;
+	bool bIsHostedSession = false;
+	bool bExitWhenFinished = true;
+	float RunTimeout = 600.f;
+	double RunStartTime = 0.0;
+	TArray<double> SucceededRunDurations;
+	FDelegateHandle PostLoadMapHandle;
+};
@@ -0,0 +1,375 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "AutoplayerController.h"
+#include "AutoplaySubsystem.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeSettings.h"
+#include "Components/PrimitiveComponent.h"
+#include "DefaultCharacter.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "InteractionComponent.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "OpenDoor.h"
+#include "UObject/UObjectIterator.h"
+#include "WinGameComponent.h"
+
+AAutoplayerController::AAutoplayerController()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// Decide and interact before the character moves and probes, like player input does.
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+}
+
+void AAutoplayerController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	Character = Cast<ADefaultCharacter>(InPawn);
+	if (!Character)
+	{
+		UE_LOG(LogAutoplay, Error, TEXT("The autoplayer can only play as a DefaultCharacter, not %s!"), *GetNameSafe(InPawn));
+	}
+	SetStep(EAutoplayStep::ChooseTarget);
+}
+
+void AAutoplayerController::UpdateControlRotation(float DeltaTime, bool bUpdatePawn)
+{
+	APawn* const MyPawn = GetPawn();
+	const FVector FocalPoint = GetFocalPoint();
+	if (!MyPawn || !FAISystem::IsValidLocation(FocalPoint))
+	{
+		Super::UpdateControlRotation(DeltaTime, bUpdatePawn);
+		return;
+	}
+
+	const FRotator NewControlRotation = (FocalPoint - MyPawn->GetPawnViewLocation()).Rotation();
+	SetControlRotation(NewControlRotation);
+	if (bUpdatePawn)
+	{
+		MyPawn->FaceRotation(NewControlRotation, DeltaTime);
+	}
+}
+
+void AAutoplayerController::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!Character || Step == EAutoplayStep::Finished) {return;}
+	UInteractionComponent* Interaction = Character->GetInteractionComponent();
+	if (!Interaction || !Interaction->IsReady()) {return;}
+
+	RunTime += DeltaTime;
+	StepTime += DeltaTime;
+
+	UAutoplaySubsystem* Autoplay = UAutoplaySubsystem::Get(this);
+	if (Autoplay && RunTime > Autoplay->GetRunTimeout())
+	{
+		EndRun(false, TEXT("the run timed out"));
+		return;
+	}
+	if (Step != EAutoplayStep::ChooseTarget && StepTime > StepTimeout)
+	{
+		GiveUpOnTarget(TEXT("the step timed out"));
+		return;
+	}
+
+	// Finish (or do all of) the move without the navigation mesh when pathfinding fails or stops short.
+	if (MoveGoal && !HasArrived())
+	{
+		bIsSteeringDirectly |= GetMoveStatus() == EPathFollowingStatus::Idle;
+		if (bIsSteeringDirectly)
+		{
+			Character->AddMovementInput((MoveGoal->GetActorLocation() - Character->GetActorLocation()).GetSafeNormal2D());
+		}
+	}
+
+	switch (Step)
+	{
+	case EAutoplayStep::ChooseTarget:
+		ChooseTarget();
+		break;
+
+	case EAutoplayStep::MoveToRotatable:
+		if (HasArrived())
+		{
+			StopMovement();
+			SetFocus(TargetActor);
+			SetStep(EAutoplayStep::RotateRotatable);
+		}
+		break;
+
+	case EAutoplayStep::RotateRotatable:
+		if (TargetDoor->IsRotatableActorAtTargetStep(TargetIndex))
+		{
+			SetStep(EAutoplayStep::ChooseTarget);
+		}
+		else if (!Interaction->IsRotating(TargetActor) && StepTime >= RotationSettleTime && IsLookingAt(TargetActor))
+		{
+			Character->Interact();
+			NumInteractions++;
+		}
+		break;
+
+	case EAutoplayStep::MoveToProp:
+		if (HasArrived())
+		{
+			StopMovement();
+			SetFocus(TargetActor);
+			SetStep(EAutoplayStep::GrabProp);
+		}
+		break;
+
+	case EAutoplayStep::GrabProp:
+		if (!IsLookingAt(TargetActor)) {break;}
+		Character->Interact();
+		NumInteractions++;
+		if (!Interaction->IsGrabbing())
+		{
+			GiveUpOnTarget(TEXT("it could not be grabbed"));
+			break;
+		}
+
+		// Look at the plate while carrying, so the prop is held out over it on arrival.
+		ClearFocus(EAIFocusPriority::Gameplay);
+		SetFocalPoint(TargetPlate->GetActorLocation());
+		MoveTowards(TargetPlate, FBuildingEscapeTuning::Get().InteractionReach * 0.75f);
+		SetStep(EAutoplayStep::CarryProp);
+		break;
+
+	case EAutoplayStep::CarryProp:
+		if (!Interaction->IsGrabbing())
+		{
+			SetStep(EAutoplayStep::ChooseTarget);
+		}
+		else if (TargetPlate->IsOverlappingActor(TargetActor) || HasArrived())
+		{
+			StopMovement();
+			Character->Interact();
+			NumInteractions++;
+			SetStep(EAutoplayStep::WaitForPlate);
+		}
+		break;
+
+	case EAutoplayStep::WaitForPlate:
+		if (StepTime >= PlateSettleTime)
+		{
+			SetStep(EAutoplayStep::ChooseTarget);
+		}
+		break;
+
+	case EAutoplayStep::MoveToWin:
+		if (TargetActor->IsOverlappingActor(Character))
+		{
+			EndRun(true, TEXT("reached the win volume"));
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void AAutoplayerController::SetStep(EAutoplayStep NewStep)
+{
+	Step = NewStep;
+	StepTime = 0.f;
+
+	if (Step == EAutoplayStep::ChooseTarget)
+	{
+		ClearFocus(EAIFocusPriority::Gameplay);
+		MoveGoal = nullptr;
+	}
+}
+
+void AAutoplayerController::ChooseTarget()
+{
+	LogSolvedDoors();
+
+	// Drop anything still held from an abandoned carry before picking something new.
+	UInteractionComponent* Interaction = Character->GetInteractionComponent();
+	if (Interaction->IsGrabbing())
+	{
+		Character->Interact();
+	}
+
+	UOpenDoor* Door = FindNextDoor();
+	if (!Door)
+	{
+		ChooseWinVolume();
+		return;
+	}
+
+	const bool bHasTarget = Door->UsesRotatableActors() ? ChooseRotatable(Door) : ChoosePropFor(Door);
+	if (!bHasTarget)
+	{
+		UE_LOG(LogAutoplay, Warning, TEXT("Autoplayer found nothing to solve %s with, skipping it."), *Door->GetOwner()->GetName());
+		SkippedActors.Add(Door->GetOwner());
+	}
+}
+
+UOpenDoor* AAutoplayerController::FindNextDoor() const
+{
+	const FVector PawnLocation = Character->GetActorLocation();
+	UOpenDoor* NextDoor = nullptr;
+	float NextDoorScore = MAX_FLT;
+
+	for (TObjectIterator<UOpenDoor> It; It; ++It)
+	{
+		UOpenDoor* Door = *It;
+		if (Door->GetWorld() != GetWorld() || !Door->IsReady() || Door->IsPuzzleSolved() || SkippedActors.Contains(Door->GetOwner())) {continue;}
+
+		// Prefer doors on the current floor, then the closest one.
+		FVector ToDoor = Door->GetOwner()->GetActorLocation() - PawnLocation;
+		ToDoor.Z *= 4.f;
+		const float Score = ToDoor.SizeSquared();
+		if (Score < NextDoorScore)
+		{
+			NextDoor = Door;
+			NextDoorScore = Score;
+		}
+	}
+	return NextDoor;
+}
+
+bool AAutoplayerController::ChooseRotatable(UOpenDoor* Door)
+{
+	const TArray<AActor*>& RotatableActors = Door->GetRotatableActors();
+	for (int32 i = 0; i < RotatableActors.Num(); i++)
+	{
+		AActor* RotatableActor = RotatableActors[i];
+		if (!RotatableActor || SkippedActors.Contains(RotatableActor) || Door->IsRotatableActorAtTargetStep(i)) {continue;}
+
+		TargetDoor = Door;
+		TargetActor = RotatableActor;
+		TargetIndex = i;
+		MoveTowards(RotatableActor, FBuildingEscapeTuning::Get().InteractionReach * 0.5f);
+		SetStep(EAutoplayStep::MoveToRotatable);
+		return true;
+	}
+	return false;
+}
+
+bool AAutoplayerController::ChoosePropFor(UOpenDoor* Door)
+{
+	AActor* Plate = Door->GetPressurePlateActor();
+	AActor* Prop = Plate ? FindNearestProp(Plate) : nullptr;
+	if (!Prop) {return false;}
+
+	TargetDoor = Door;
+	TargetPlate = Plate;
+	TargetActor = Prop;
+	MoveTowards(Prop, FBuildingEscapeTuning::Get().InteractionReach * 0.5f);
+	SetStep(EAutoplayStep::MoveToProp);
+	return true;
+}
+
+AActor* AAutoplayerController::FindNearestProp(const AActor* Plate) const
+{
+	// Props already weighing down any plate stay where they are.
+	TArray<AActor*> Plates;
+	for (TObjectIterator<UOpenDoor> It; It; ++It)
+	{
+		AActor* DoorPlate = It->GetWorld() == GetWorld() ? It->GetPressurePlateActor() : nullptr;
+		if (DoorPlate)
+		{
+			Plates.AddUnique(DoorPlate);
+		}
+	}
+
+	AActor* NearestProp = nullptr;
+	float NearestDistance = MAX_FLT;
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		AActor* Actor = *It;
+		const UPrimitiveComponent* Root = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+		if (!Root || !Root->IsSimulatingPhysics() || Root->GetCollisionObjectType() != ECC_PhysicsBody) {continue;}
+		if (SkippedActors.Contains(Actor) || Plates.ContainsByPredicate([Actor](const AActor* Other) {return Other->IsOverlappingActor(Actor);})) {continue;}
+
+		// The whole trip: to the prop, then to the plate.
+		const float Distance = FVector::Dist(Character->GetActorLocation(), Actor->GetActorLocation()) + FVector::Dist(Actor->GetActorLocation(), Plate->GetActorLocation());
+		if (Distance < NearestDistance)
+		{
+			NearestProp = Actor;
+			NearestDistance = Distance;
+		}
+	}
+	return NearestProp;
+}
+
+void AAutoplayerController::ChooseWinVolume()
+{
+	for (TObjectIterator<UWinGameComponent> It; It; ++It)
+	{
+		if (It->GetWorld() != GetWorld() || !It->WinGameTriggerVolume) {continue;}
+
+		TargetDoor = nullptr;
+		TargetActor = It->WinGameTriggerVolume;
+		MoveTowards(TargetActor, 0.f);
+		SetStep(EAutoplayStep::MoveToWin);
+		return;
+	}
+
+	EndRun(false, TEXT("every door is open but there is no win volume"));
+}
+
+void AAutoplayerController::MoveTowards(AActor* Target, float AcceptanceRadius)
+{
+	MoveGoal = Target;
+	MoveAcceptanceRadius = AcceptanceRadius;
+	bIsSteeringDirectly = MoveToActor(Target, AcceptanceRadius) == EPathFollowingRequestResult::Failed;
+}
+
+bool AAutoplayerController::HasArrived() const
+{
+	return MoveGoal && FVector::Dist2D(Character->GetActorLocation(), MoveGoal->GetActorLocation()) <= MoveAcceptanceRadius;
+}
+
+bool AAutoplayerController::IsLookingAt(const AActor* Target) const
+{
+	return Character->GetInteractionComponent()->GetProbe().HitActor == Target;
+}
+
+void AAutoplayerController::GiveUpOnTarget(const TCHAR* Reason)
+{
+	UE_LOG(LogAutoplay, Warning, TEXT("Autoplayer skipped %s: %s."), *GetNameSafe(TargetActor), Reason);
+
+	// Nothing else is worth trying once the way to the win volume is blocked.
+	if (Step == EAutoplayStep::MoveToWin)
+	{
+		EndRun(false, FString::Printf(TEXT("could not reach the win volume, %s"), Reason));
+		return;
+	}
+
+	StopMovement();
+	SkippedActors.Add(TargetActor);
+	SetStep(EAutoplayStep::ChooseTarget);
+}
+
+void AAutoplayerController::LogSolvedDoors()
+{
+	for (TObjectIterator<UOpenDoor> It; It; ++It)
+	{
+		UOpenDoor* Door = *It;
+		if (Door->GetWorld() != GetWorld() || !Door->IsPuzzleSolved() || SolvedDoors.Contains(Door)) {continue;}
+
+		SolvedDoors.Add(Door);
+		UE_LOG(LogAutoplay, Log, TEXT("%s solved after %.2f s."), *Door->GetOwner()->GetName(), RunTime);
+	}
+}
+
+void AAutoplayerController::EndRun(bool bSucceeded, const FString& Reason)
+{
+	SetStep(EAutoplayStep::Finished);
+	StopMovement();
+
+	UE_LOG(LogAutoplay, Log, TEXT("Autoplayer %s after %.2f s: %d doors solved, %d interactions, %d targets skipped."),
+		*Reason, RunTime, SolvedDoors.Num(), NumInteractions, SkippedActors.Num());
+
+	if (UAutoplaySubsystem* Autoplay = UAutoplaySubsystem::Get(this))
+	{
+		Autoplay->EndRun(GetWorld(), bSucceeded, Reason);
+	}
+}
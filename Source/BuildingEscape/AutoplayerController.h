@@ -0,0 +1,104 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "AutoplayerController.generated.h"
+
+class ADefaultCharacter;
+class UOpenDoor;
+
+UENUM()
+enum class EAutoplayStep : uint8
+{
+	ChooseTarget,
+	MoveToRotatable,
+	RotateRotatable,
+	MoveToProp,
+	GrabProp,
+	CarryProp,
+	WaitForPlate,
+	MoveToWin,
+	Finished
+};
+
+// Plays the tower like a player would, through ADefaultCharacter and its InteractionComponent: walks to the nearest
+// unsolved door's puzzle, turns its rotatable actors with Interact until the door reports them solved, or carries
+// physics props onto its pressure plate with the grab path, and once every door is open walks into the win volume.
+// Uses the navigation mesh where there is one and steers straight at the target where there is not.
+UCLASS()
+class BUILDINGESCAPE_API AAutoplayerController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+	AAutoplayerController();
+
+	virtual void Tick(float DeltaTime) override;
+
+	// Unlike the default, keep pitching towards the focus so the interaction trace can reach props on the floor.
+	virtual void UpdateControlRotation(float DeltaTime, bool bUpdatePawn = true) override;
+
+protected:
+	virtual void OnPossess(APawn* InPawn) override;
+
+private:
+	void ChooseTarget();
+	bool ChooseRotatable(UOpenDoor* Door);
+	bool ChoosePropFor(UOpenDoor* Door);
+	void ChooseWinVolume();
+	UOpenDoor* FindNextDoor() const;
+	AActor* FindNearestProp(const AActor* Plate) const;
+
+	void MoveTowards(AActor* Target, float AcceptanceRadius);
+	bool HasArrived() const;
+	bool IsLookingAt(const AActor* Target) const;
+	void SetStep(EAutoplayStep NewStep);
+	void GiveUpOnTarget(const TCHAR* Reason);
+	void LogSolvedDoors();
+	void EndRun(bool bSucceeded, const FString& Reason);
+
+	// Member Variables
+	EAutoplayStep Step = EAutoplayStep::ChooseTarget;
+	float StepTime = 0.f;
+	float RunTime = 0.f;
+	float MoveAcceptanceRadius = 0.f;
+	bool bIsSteeringDirectly = false;
+	int32 TargetIndex = INDEX_NONE;
+	int32 NumInteractions = 0;
+
+	// Seconds a single step may take before the target is skipped.
+	UPROPERTY(EditAnyWhere)
+	float StepTimeout = 30.f;
+
+	// Seconds to wait on a rotatable actor that stopped turning before interacting with it again.
+	UPROPERTY(EditAnyWhere)
+	float RotationSettleTime = 0.25f;
+
+	// Seconds to wait after dropping a prop for the plate and door to react.
+	UPROPERTY(EditAnyWhere)
+	float PlateSettleTime = 1.5f;
+
+	UPROPERTY()
+	ADefaultCharacter* Character = nullptr;
+
+	UPROPERTY()
+	UOpenDoor* TargetDoor = nullptr;
+
+	UPROPERTY()
+	AActor* TargetActor = nullptr;
+
+	UPROPERTY()
+	AActor* TargetPlate = nullptr;
+
+	UPROPERTY()
+	AActor* MoveGoal = nullptr;
+
+	// Targets that could not be reached or used, never chosen again this run.
+	UPROPERTY()
+	TSet<AActor*> SkippedActors;
+
+	UPROPERTY()
+	TSet<UOpenDoor*> SolvedDoors;
+};
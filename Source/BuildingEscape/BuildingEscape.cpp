@@ -1,6 +1,34 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "BuildingEscape.h"
+#include "BuildingEscapeFrameGovernor.h"
+#include "BuildingEscapeStartupTiming.h"
+#include "BuildingEscapeTelemetry.h"
 #include "Modules/ModuleManager.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, BuildingEscape, "BuildingEscape" );
+DEFINE_LOG_CATEGORY(LogBuildingEscape);
+DEFINE_LOG_CATEGORY(LogStartupTiming);
+DEFINE_LOG_CATEGORY(LogAutoplay);
+DEFINE_LOG_CATEGORY(LogInteraction);
+
+class FBuildingEscapeModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(FBuildingEscapeModule::StartupModule);
+		BuildingEscapeStartupTiming::Register();
+		BuildingEscapeFrameGovernor::Register();
+		BuildingEscapeTelemetry::Register();
+	}
+
+	virtual void ShutdownModule() override
+	{
+		BuildingEscapeTelemetry::Unregister();
+		BuildingEscapeFrameGovernor::Unregister();
+		BuildingEscapeStartupTiming::Unregister();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FBuildingEscapeModule, BuildingEscape, "BuildingEscape" );
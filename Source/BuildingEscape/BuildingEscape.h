@@ -4,3 +4,34 @@
 
 #include "CoreMinimal.h"
 
+// Shipping and Test builds only compile in warnings and errors, so Log/Verbose statements on hot paths
+// (including their string formatting) compile away entirely.
+#if UE_BUILD_SHIPPING || UE_BUILD_TEST
+#define BUILDINGESCAPE_LOG_DEFAULT_VERBOSITY Warning
+#define BUILDINGESCAPE_LOG_COMPILE_VERBOSITY Warning
+#else
+#define BUILDINGESCAPE_LOG_DEFAULT_VERBOSITY Log
+#define BUILDINGESCAPE_LOG_COMPILE_VERBOSITY All
+#endif
+
+// General module logging (setup errors, save system, ...).
+DECLARE_LOG_CATEGORY_EXTERN(LogBuildingEscape, BUILDINGESCAPE_LOG_DEFAULT_VERBOSITY, BUILDINGESCAPE_LOG_COMPILE_VERBOSITY);
+
+// Cold start phases, see BuildingEscapeStartupTiming. Kept at Log in every build so Test builds report them too.
+DECLARE_LOG_CATEGORY_EXTERN(LogStartupTiming, Log, Log);
+
+// Autoplayer runs and their timings, see UAutoplaySubsystem. Also kept at Log in every build.
+DECLARE_LOG_CATEGORY_EXTERN(LogAutoplay, Log, Log);
+
+// Per-frame interaction tracing. Raise at runtime with "log LogInteraction Verbose".
+DECLARE_LOG_CATEGORY_EXTERN(LogInteraction, BUILDINGESCAPE_LOG_DEFAULT_VERBOSITY, BUILDINGESCAPE_LOG_COMPILE_VERBOSITY);
+
+
+// Async load priorities for the module's package loads and streamed floors; higher is serviced first. Whatever the
+// first interactive frame needs goes ahead of floors the player has not reached and of background sessions.
+namespace BuildingEscapeLoadPriority
+{
+	constexpr int32 MainLevel = 100;
+	constexpr int32 PlayerFloor = 50;
+	constexpr int32 HostedSession = 0;
+}
@@ -0,0 +1,23 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "BuildingEscapeDebug.h"
+#include "HAL/IConsoleManager.h"
+
+#if BUILDINGESCAPE_DEBUG_DRAW
+
+static TAutoConsoleVariable<int32> CVarDebugDraw(
+	TEXT("be.DebugDraw"),
+	0,
+	TEXT("Draw gameplay debug information (bitmask).\n")
+	TEXT(" 1: interaction traces\n")
+	TEXT(" 2: pressure plate overlaps and mass\n")
+	TEXT(" 4: door states"),
+	ECVF_Cheat);
+
+bool BuildingEscapeDebug::IsDrawEnabled(EDebugDrawFlags Flag)
+{
+	return (CVarDebugDraw.GetValueOnGameThread() & Flag) != 0;
+}
+
+#endif
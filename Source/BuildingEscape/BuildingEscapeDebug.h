@@ -0,0 +1,30 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Debug drawing is compiled out of Shipping and Test builds. Wrap every call site in #if BUILDINGESCAPE_DEBUG_DRAW.
+#if ENABLE_DRAW_DEBUG && !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+#define BUILDINGESCAPE_DEBUG_DRAW 1
+#else
+#define BUILDINGESCAPE_DEBUG_DRAW 0
+#endif
+
+#if BUILDINGESCAPE_DEBUG_DRAW
+
+namespace BuildingEscapeDebug
+{
+	// Bits of the be.DebugDraw console variable.
+	enum EDebugDrawFlags : int32
+	{
+		Traces = 1 << 0,
+		PressurePlates = 1 << 1,
+		Doors = 1 << 2
+	};
+
+	// Return true if be.DebugDraw has Flag set.
+	bool IsDrawEnabled(EDebugDrawFlags Flag);
+}
+
+#endif
@@ -0,0 +1,148 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "BuildingEscapeFrameGovernor.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeSettings.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("BuildingEscape"), STATGROUP_BuildingEscape, STATCAT_Advanced);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Game thread ms (smoothed)"), STAT_GovernorGameThreadMs, STATGROUP_BuildingEscape);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Game thread budget ms"), STAT_GovernorBudgetMs, STATGROUP_BuildingEscape);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Governor level"), STAT_GovernorLevel, STATGROUP_BuildingEscape);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Distant door tick interval"), STAT_GovernorDistantTickInterval, STATGROUP_BuildingEscape);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Probe frame interval"), STAT_GovernorProbeFrameInterval, STATGROUP_BuildingEscape);
+
+namespace
+{
+	// What each level asks of low priority work. Level 0 is full quality.
+	struct FGovernorLevel
+	{
+		float DistantTickInterval;
+		int32 ProbeFrameInterval;
+		bool bSnapMaterials;
+	};
+
+	const FGovernorLevel Levels[] =
+	{
+		{0.f, 1, false},
+		{0.1f, 2, false},
+		{0.25f, 3, true},
+		{0.5f, 4, true},
+	};
+
+	// Hysteresis: step up after this many frames over budget, step down after this many frames under LowerFraction
+	// of the budget.
+	const int32 FramesToRaise = 30;
+	const int32 FramesToLower = 120;
+	const float LowerFraction = 0.75f;
+	const float SmoothingAlpha = 0.1f;
+
+	int32 CurrentLevel = 0;
+	int32 FramesOverBudget = 0;
+	int32 FramesUnderBudget = 0;
+	float SmoothedGameThreadMs = 0.f;
+	double LastEndFrameTime = 0.0;
+	FDelegateHandle EndFrameHandle;
+	FSimpleMulticastDelegate LevelChangedDelegate;
+
+	void SetLevel(int32 NewLevel)
+	{
+		UE_LOG(LogBuildingEscape, Log, TEXT("Frame governor level %d -> %d (game thread %.2f ms, budget %.2f ms)."),
+			CurrentLevel, NewLevel, SmoothedGameThreadMs, FBuildingEscapeTuning::Get().GovernorBudgetMs);
+		CurrentLevel = NewLevel;
+		FramesOverBudget = 0;
+		FramesUnderBudget = 0;
+		LevelChangedDelegate.Broadcast();
+	}
+
+	void Update()
+	{
+		// Time the frame here rather than reading GGameThreadTime, which only FViewport::Draw sets, so headless and hosted
+		// worlds are governed too. Time spent sleeping to hold the frame rate cap is not work, so it is left out.
+		const double Now = FPlatformTime::Seconds();
+		const double FrameSeconds = LastEndFrameTime > 0.0 ? Now - LastEndFrameTime : 0.0;
+		LastEndFrameTime = Now;
+		if (FrameSeconds <= 0.0) {return;}
+
+		const float GameThreadMs = (float)(FMath::Max(0.0, FrameSeconds - FApp::GetIdleTime()) * 1000.0);
+		SmoothedGameThreadMs = FMath::Lerp(SmoothedGameThreadMs, GameThreadMs, SmoothingAlpha);
+
+		const float BudgetMs = FBuildingEscapeTuning::Get().GovernorBudgetMs;
+		if (BudgetMs <= 0.f)
+		{
+			if (CurrentLevel != 0) {SetLevel(0);}
+		}
+		else if (SmoothedGameThreadMs > BudgetMs)
+		{
+			FramesUnderBudget = 0;
+			if (++FramesOverBudget >= FramesToRaise && CurrentLevel < BuildingEscapeFrameGovernor::GetMaxLevel())
+			{
+				SetLevel(CurrentLevel + 1);
+			}
+		}
+		else if (SmoothedGameThreadMs < BudgetMs * LowerFraction)
+		{
+			FramesOverBudget = 0;
+			if (++FramesUnderBudget >= FramesToLower && CurrentLevel > 0)
+			{
+				SetLevel(CurrentLevel - 1);
+			}
+		}
+		else
+		{
+			FramesOverBudget = 0;
+			FramesUnderBudget = 0;
+		}
+
+		SET_FLOAT_STAT(STAT_GovernorGameThreadMs, SmoothedGameThreadMs);
+		SET_FLOAT_STAT(STAT_GovernorBudgetMs, BudgetMs);
+		SET_DWORD_STAT(STAT_GovernorLevel, CurrentLevel);
+		SET_FLOAT_STAT(STAT_GovernorDistantTickInterval, Levels[CurrentLevel].DistantTickInterval);
+		SET_DWORD_STAT(STAT_GovernorProbeFrameInterval, Levels[CurrentLevel].ProbeFrameInterval);
+	}
+}
+
+void BuildingEscapeFrameGovernor::Register()
+{
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&Update);
+}
+
+void BuildingEscapeFrameGovernor::Unregister()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	LastEndFrameTime = 0.0;
+}
+
+int32 BuildingEscapeFrameGovernor::GetLevel()
+{
+	return CurrentLevel;
+}
+
+int32 BuildingEscapeFrameGovernor::GetMaxLevel()
+{
+	return ARRAY_COUNT(Levels) - 1;
+}
+
+float BuildingEscapeFrameGovernor::GetDistantTickInterval()
+{
+	return Levels[CurrentLevel].DistantTickInterval;
+}
+
+int32 BuildingEscapeFrameGovernor::GetProbeFrameInterval()
+{
+	return Levels[CurrentLevel].ProbeFrameInterval;
+}
+
+bool BuildingEscapeFrameGovernor::ShouldSnapMaterials()
+{
+	return Levels[CurrentLevel].bSnapMaterials;
+}
+
+FSimpleMulticastDelegate& BuildingEscapeFrameGovernor::OnLevelChanged()
+{
+	return LevelChangedDelegate;
+}
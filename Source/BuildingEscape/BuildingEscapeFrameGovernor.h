@@ -0,0 +1,33 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Times the game thread's work every frame and, while it stays over be.Governor.BudgetMs, steps up a load level that
+// low priority work reads to do less: doors away from the player tick less often, the interaction probe behind the
+// reticle traces every few frames instead of every frame, and rotatable actor materials snap instead of blending.
+// The level only drops again once the frame time has stayed well under budget for a while, so it does not flap.
+// Decisions show up under "stat BuildingEscape" and are logged to LogBuildingEscape.
+namespace BuildingEscapeFrameGovernor
+{
+	// Subscribe to the engine's end of frame delegate. Called from the module's StartupModule.
+	void Register();
+	void Unregister();
+
+	// 0 when the game thread is within budget, up to GetMaxLevel() under sustained load.
+	int32 GetLevel();
+	int32 GetMaxLevel();
+
+	// Minimum seconds between ticks for doors further than be.Governor.NearDistance from the player. 0 at level 0.
+	float GetDistantTickInterval();
+
+	// Frames between interaction probes driven by the InteractionComponent's own tick. 1 at level 0.
+	int32 GetProbeFrameInterval();
+
+	// True when material blends should jump straight to their target.
+	bool ShouldSnapMaterials();
+
+	// Broadcast whenever the level changes, for work that caches what the level asks of it.
+	FSimpleMulticastDelegate& OnLevelChanged();
+}
@@ -2,4 +2,81 @@
 
 
 #include "BuildingEscapeGameModeBase.h"
+#include "AutoplayerController.h"
+#include "AutoplaySubsystem.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapePlayerController.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
 
+ABuildingEscapeGameModeBase::ABuildingEscapeGameModeBase()
+{
+	PlayerControllerClass = ABuildingEscapePlayerController::StaticClass();
+	AutoplayerControllerClass = AAutoplayerController::StaticClass();
+}
+
+void ABuildingEscapeGameModeBase::StartPlay()
+{
+	// Everything has begun play after this, so doors and the HUD have already found the player's character.
+	Super::StartPlay();
+
+	UAutoplaySubsystem* Autoplay = UAutoplaySubsystem::Get(this);
+	if (!Autoplay || !Autoplay->ShouldAutoplay(GetWorld())) {return;}
+
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	if (!PlayerPawn)
+	{
+		UE_LOG(LogAutoplay, Error, TEXT("Autoplay could not start in %s: there is no player pawn to take over."), *GetWorld()->GetMapName());
+		return;
+	}
+
+	// The player controller stays, without a pawn, for the camera manager and HUD, and keeps watching the character.
+	PlayerController->UnPossess();
+	if (!StartAutoplayer(PlayerPawn)) {return;}
+	PlayerController->SetViewTarget(PlayerPawn);
+	Autoplay->StartRun(GetWorld());
+}
+
+AAutoplayerController* ABuildingEscapeGameModeBase::StartAutoplayer(APawn* Pawn)
+{
+	if (!AutoplayerControllerClass) {return nullptr;}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.ObjectFlags |= RF_Transient;
+	AAutoplayerController* Autoplayer = GetWorld()->SpawnActor<AAutoplayerController>(AutoplayerControllerClass, SpawnParams);
+	if (!Autoplayer) {return nullptr;}
+
+	if (!Pawn)
+	{
+		AActor* StartSpot = FindPlayerStart(Autoplayer);
+		Pawn = StartSpot ? SpawnDefaultPawnAtTransform(Autoplayer, StartSpot->GetActorTransform()) : nullptr;
+	}
+	if (!Pawn)
+	{
+		UE_LOG(LogAutoplay, Error, TEXT("Autoplay could not spawn a pawn in %s."), *GetWorld()->GetMapName());
+		Autoplayer->Destroy();
+		return nullptr;
+	}
+
+	Autoplayer->Possess(Pawn);
+	return Autoplayer;
+}
+
+APawn* ABuildingEscapeGameModeBase::GetTowerPlayer(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	if (!World) {return nullptr;}
+
+	for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
+	{
+		AController* Controller = It->Get();
+		if (Controller && Controller->GetPawn() && (Controller->IsLocalPlayerController() || Controller->IsA<AAutoplayerController>()))
+		{
+			return Controller->GetPawn();
+		}
+	}
+	return nullptr;
+}
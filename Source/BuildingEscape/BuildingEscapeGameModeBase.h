@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "Templates/SubclassOf.h"
 #include "BuildingEscapeGameModeBase.generated.h"
 
 /**
@@ -13,5 +14,21 @@ UCLASS()
 class BUILDINGESCAPE_API ABuildingEscapeGameModeBase : public AGameModeBase
 {
 	GENERATED_BODY()
-	
+
+public:
+	ABuildingEscapeGameModeBase();
+
+	// Hands the player's character to an autoplayer when running with -Autoplay=N.
+	virtual void StartPlay() override;
+
+	// Possess Pawn with a new autoplayer. Without a Pawn, spawn the default pawn at a player start for it.
+	class AAutoplayerController* StartAutoplayer(APawn* Pawn);
+
+	// Return the pawn playing the tower in WorldContextObject's world: the local player's, or the autoplayer's.
+	// Worlds of a simulation host have no player controller, so do not assume the first player controller has it.
+	static APawn* GetTowerPlayer(const UObject* WorldContextObject);
+
+private:
+	UPROPERTY(EditAnyWhere, Category = "Autoplay")
+	TSubclassOf<class AAutoplayerController> AutoplayerControllerClass;
 };
@@ -0,0 +1,113 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "BuildingEscapeMemReport.h"
+
+#if BUILDINGESCAPE_MEM_REPORT
+
+#include "Components/ActorComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/OutputDevice.h"
+#include "Misc/Paths.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/UObjectIterator.h"
+
+namespace
+{
+	struct FClassMemStats
+	{
+		int32 Count = 0;
+		SIZE_T ObjectBytes = 0;
+		SIZE_T ResourceBytes = 0;
+
+		SIZE_T GetTotalBytes() const {return ObjectBytes + ResourceBytes;}
+	};
+}
+
+void BuildingEscapeMemReport::Run(UWorld* World, FOutputDevice& Ar, bool bWriteCsv)
+{
+	if (!World) {return;}
+
+	TMap<UClass*, FClassMemStats> StatsByClass;
+	FClassMemStats Totals;
+	int32 NumActors = 0;
+	int32 NumComponents = 0;
+	int32 NumMaterialInstanceDynamics = 0;
+	int32 NumClusterRoots = 0;
+	int32 NumClusteredObjects = 0;
+
+	for (TObjectIterator<UObject> It; It; ++It)
+	{
+		UObject* Object = *It;
+		if (Object->IsPendingKill() || Object->IsTemplate()) {continue;}
+
+		// Everything placed or spawned in the world lives (directly or indirectly) inside one of its levels.
+		const ULevel* Level = Object->GetTypedOuter<ULevel>();
+		if (!Level || Level->OwningWorld != World) {continue;}
+
+		// Exclusive sizes only, so nested objects are not counted twice.
+		FArchiveCountMem CountMem(Object);
+		FClassMemStats& Stats = StatsByClass.FindOrAdd(Object->GetClass());
+		Stats.Count++;
+		Stats.ObjectBytes += CountMem.GetMax();
+		Stats.ResourceBytes += Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+
+		if (Object->IsA<AActor>()) {NumActors++;}
+		else if (Object->IsA<UActorComponent>()) {NumComponents++;}
+		else if (Object->IsA<UMaterialInstanceDynamic>()) {NumMaterialInstanceDynamics++;}
+
+		if (Object->HasAnyInternalFlags(EInternalObjectFlags::ClusterRoot)) {NumClusterRoots++;}
+		if (GUObjectArray.ObjectToObjectItem(Object)->GetOwnerIndex() != 0) {NumClusteredObjects++;}
+	}
+
+	StatsByClass.ValueSort([](const FClassMemStats& A, const FClassMemStats& B)
+	{
+		return A.GetTotalBytes() > B.GetTotalBytes();
+	});
+
+	FString Csv = TEXT("Class,Count,ObjectBytes,ResourceBytes\n");
+	Ar.Logf(TEXT("%-48s %8s %12s %12s"), TEXT("Class"), TEXT("Count"), TEXT("ObjectKB"), TEXT("ResourceKB"));
+	for (const TPair<UClass*, FClassMemStats>& Pair : StatsByClass)
+	{
+		const FClassMemStats& Stats = Pair.Value;
+		Ar.Logf(TEXT("%-48s %8d %12.1f %12.1f"), *Pair.Key->GetName(), Stats.Count, Stats.ObjectBytes / 1024.f, Stats.ResourceBytes / 1024.f);
+		Csv += FString::Printf(TEXT("%s,%d,%llu,%llu\n"), *Pair.Key->GetName(), Stats.Count, (uint64)Stats.ObjectBytes, (uint64)Stats.ResourceBytes);
+
+		Totals.Count += Stats.Count;
+		Totals.ObjectBytes += Stats.ObjectBytes;
+		Totals.ResourceBytes += Stats.ResourceBytes;
+	}
+
+	Ar.Logf(TEXT("%d objects (%.1f KB objects, %.1f KB resources) in %s: %d actors, %d components, %d material instance dynamics."),
+		Totals.Count, Totals.ObjectBytes / 1024.f, Totals.ResourceBytes / 1024.f, *World->GetMapName(), NumActors, NumComponents, NumMaterialInstanceDynamics);
+	Ar.Logf(TEXT("%d objects in %d GC clusters."), NumClusteredObjects, NumClusterRoots);
+
+	if (bWriteCsv)
+	{
+		const FString CsvPath = FPaths::ProfilingDir() / TEXT("MemReports") / FString::Printf(TEXT("BuildingEscape-%s-%s.csv"), *World->GetMapName(), *FDateTime::Now().ToString());
+		if (FFileHelper::SaveStringToFile(Csv, *CsvPath))
+		{
+			Ar.Logf(TEXT("Wrote %s"), *CsvPath);
+		}
+		else
+		{
+			Ar.Logf(TEXT("Could not write %s"), *CsvPath);
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice BuildingEscapeMemReportCommand(
+	TEXT("be.MemReport"),
+	TEXT("List UObject counts and estimated memory per class for the current world. Pass -csv to also write Saved/Profiling/MemReports/*.csv."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		BuildingEscapeMemReport::Run(World, Ar, Args.Contains(TEXT("-csv")));
+	}));
+
+#endif
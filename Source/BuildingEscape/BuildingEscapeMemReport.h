@@ -0,0 +1,23 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FOutputDevice;
+class UWorld;
+
+// The memory report is compiled out of Shipping builds.
+#define BUILDINGESCAPE_MEM_REPORT !UE_BUILD_SHIPPING
+
+#if BUILDINGESCAPE_MEM_REPORT
+
+namespace BuildingEscapeMemReport
+{
+	// List UObject counts and estimated bytes per class for every object in World's levels, plus totals for actors,
+	// components, material instance dynamics and GC clusters. Optionally also writes the table to
+	// Saved/Profiling/MemReports as CSV. Run from the console with "be.MemReport [-csv]".
+	void Run(UWorld* World, FOutputDevice& Ar, bool bWriteCsv);
+}
+
+#endif
@@ -0,0 +1,24 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "BuildingEscapePlayerController.h"
+#include "Camera/CameraShake.h"
+#include "Camera/PlayerCameraManager.h"
+#include "HeadBobCameraModifier.h"
+#include "UObject/ConstructorHelpers.h"
+
+ABuildingEscapePlayerController::ABuildingEscapePlayerController()
+{
+	static ConstructorHelpers::FClassFinder<UCameraShake> HeadBobShakeObj(
+		TEXT("/Game/Blueprints/HeadBob_BP")
+	);
+	HeadBobShakeClass = HeadBobShakeObj.Class;
+}
+
+void ABuildingEscapePlayerController::ClientPlayCameraShake_Implementation(TSubclassOf<UCameraShake> Shake, float Scale, ECameraAnimPlaySpace::Type PlaySpace, FRotator UserPlaySpaceRot)
+{
+	const bool bIsHeadBobShake = HeadBobShakeClass && Shake && Shake->IsChildOf(HeadBobShakeClass);
+	if (bIsHeadBobShake && PlayerCameraManager && PlayerCameraManager->FindCameraModifierByClass(UHeadBobCameraModifier::StaticClass())) {return;}
+
+	Super::ClientPlayCameraShake_Implementation(Shake, Scale, PlaySpace, UserPlaySpaceRot);
+}
@@ -0,0 +1,29 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerController.h"
+#include "Templates/SubclassOf.h"
+#include "BuildingEscapePlayerController.generated.h"
+
+class UCameraShake;
+
+// The tower's player controller. DefaultCharacter_BP still plays the HeadBob_BP camera shake every tick; while the
+// native UHeadBobCameraModifier is on the camera that shake is dropped here, so the bob is applied once and
+// be.Camera.HeadBob controls it.
+UCLASS()
+class BUILDINGESCAPE_API ABuildingEscapePlayerController : public APlayerController
+{
+	GENERATED_BODY()
+
+public:
+	ABuildingEscapePlayerController();
+
+	virtual void ClientPlayCameraShake_Implementation(TSubclassOf<UCameraShake> Shake, float Scale, ECameraAnimPlaySpace::Type PlaySpace, FRotator UserPlaySpaceRot) override;
+
+private:
+	// The Blueprint head bob shake the native modifier replaces.
+	UPROPERTY(EditAnyWhere, Category = "Camera")
+	TSubclassOf<UCameraShake> HeadBobShakeClass;
+};
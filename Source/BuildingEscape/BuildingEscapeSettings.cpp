@@ -0,0 +1,148 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "BuildingEscapeSettings.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarInteractionReach(
+	TEXT("be.Interaction.Reach"),
+	200.f,
+	TEXT("How far the player can grab and rotate objects, in cm."));
+
+static TAutoConsoleVariable<float> CVarInteractionTickInterval(
+	TEXT("be.Interaction.TickInterval"),
+	0.f,
+	TEXT("Seconds between interaction ticks. 0 ticks every frame."));
+
+static TAutoConsoleVariable<float> CVarRotationLerpRate(
+	TEXT("be.Rotation.LerpRate"),
+	1.6f,
+	TEXT("Rate at which rotatable actors lerp toward their target yaw."));
+
+static TAutoConsoleVariable<float> CVarRotationFadeOutThreshold(
+	TEXT("be.Rotation.FadeOutThreshold"),
+	15.f,
+	TEXT("Degrees from the target yaw at which the rotation sound fades out."));
+
+static TAutoConsoleVariable<float> CVarRotationSnapThreshold(
+	TEXT("be.Rotation.SnapThreshold"),
+	0.4f,
+	TEXT("Degrees from the target yaw at which a rotation snaps into place."));
+
+static TAutoConsoleVariable<float> CVarMaterialLerpRate(
+	TEXT("be.Rotation.MaterialLerpRate"),
+	0.8f,
+	TEXT("Rate at which rotatable actor materials blend toward solved/unsolved."));
+
+static TAutoConsoleVariable<float> CVarDoorOpenSpeedScale(
+	TEXT("be.Door.OpenSpeedScale"),
+	1.f,
+	TEXT("Multiplier applied to every door's open speed."));
+
+static TAutoConsoleVariable<float> CVarDoorCloseSpeedScale(
+	TEXT("be.Door.CloseSpeedScale"),
+	1.f,
+	TEXT("Multiplier applied to every door's close speed."));
+
+static TAutoConsoleVariable<float> CVarDoorDelayScale(
+	TEXT("be.Door.DelayScale"),
+	1.f,
+	TEXT("Multiplier applied to every door's open and close delays."));
+
+static TAutoConsoleVariable<float> CVarDoorTickInterval(
+	TEXT("be.Door.TickInterval"),
+	0.f,
+	TEXT("Seconds between door ticks. 0 ticks every frame."));
+
+static TAutoConsoleVariable<float> CVarDeferredInitBudgetMs(
+	TEXT("be.DeferredInit.BudgetMs"),
+	1.f,
+	TEXT("Milliseconds per frame spent on deferred component initialization. At least one item runs every frame."));
+
+static TAutoConsoleVariable<float> CVarGovernorBudgetMs(
+	TEXT("be.Governor.BudgetMs"),
+	12.f,
+	TEXT("Game thread milliseconds per frame before the frame governor cuts back low priority work. 0 turns it off."));
+
+static TAutoConsoleVariable<float> CVarGovernorNearDistance(
+	TEXT("be.Governor.NearDistance"),
+	1500.f,
+	TEXT("Doors closer than this to the player, in cm, keep their normal tick interval under load."));
+
+static FBuildingEscapeTuning GBuildingEscapeTuning;
+
+const FBuildingEscapeTuning& FBuildingEscapeTuning::Get()
+{
+	return GBuildingEscapeTuning;
+}
+
+FSimpleMulticastDelegate& FBuildingEscapeTuning::OnChanged()
+{
+	static FSimpleMulticastDelegate OnTuningChanged;
+	return OnTuningChanged;
+}
+
+// Called by the console variable system after any console variable changes.
+static void RefreshBuildingEscapeTuning()
+{
+	FBuildingEscapeTuning NewTuning;
+	NewTuning.InteractionReach = CVarInteractionReach.GetValueOnGameThread();
+	NewTuning.InteractionTickInterval = CVarInteractionTickInterval.GetValueOnGameThread();
+	NewTuning.RotationLerpRate = CVarRotationLerpRate.GetValueOnGameThread();
+	NewTuning.RotationFadeOutThreshold = CVarRotationFadeOutThreshold.GetValueOnGameThread();
+	NewTuning.RotationSnapThreshold = CVarRotationSnapThreshold.GetValueOnGameThread();
+	NewTuning.MaterialLerpRate = CVarMaterialLerpRate.GetValueOnGameThread();
+	NewTuning.DoorOpenSpeedScale = CVarDoorOpenSpeedScale.GetValueOnGameThread();
+	NewTuning.DoorCloseSpeedScale = CVarDoorCloseSpeedScale.GetValueOnGameThread();
+	NewTuning.DoorDelayScale = CVarDoorDelayScale.GetValueOnGameThread();
+	NewTuning.DoorTickInterval = CVarDoorTickInterval.GetValueOnGameThread();
+	NewTuning.DeferredInitBudgetMs = CVarDeferredInitBudgetMs.GetValueOnGameThread();
+	NewTuning.GovernorBudgetMs = CVarGovernorBudgetMs.GetValueOnGameThread();
+	NewTuning.GovernorNearDistance = CVarGovernorNearDistance.GetValueOnGameThread();
+
+	if (FMemory::Memcmp(&NewTuning, &GBuildingEscapeTuning, sizeof(FBuildingEscapeTuning)) == 0) {return;}
+
+	GBuildingEscapeTuning = NewTuning;
+	FBuildingEscapeTuning::OnChanged().Broadcast();
+}
+
+static FAutoConsoleVariableSink CVarBuildingEscapeTuningSink(FConsoleCommandDelegate::CreateStatic(&RefreshBuildingEscapeTuning));
+
+void UBuildingEscapeSettings::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (IsTemplate())
+	{
+		ApplyToConsoleVariables();
+	}
+}
+
+#if WITH_EDITOR
+void UBuildingEscapeSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	ApplyToConsoleVariables();
+}
+#endif
+
+void UBuildingEscapeSettings::ApplyToConsoleVariables() const
+{
+	CVarInteractionReach->Set(InteractionReach, ECVF_SetByProjectSetting);
+	CVarInteractionTickInterval->Set(InteractionTickInterval, ECVF_SetByProjectSetting);
+	CVarRotationLerpRate->Set(RotationLerpRate, ECVF_SetByProjectSetting);
+	CVarRotationFadeOutThreshold->Set(RotationFadeOutThreshold, ECVF_SetByProjectSetting);
+	CVarRotationSnapThreshold->Set(RotationSnapThreshold, ECVF_SetByProjectSetting);
+	CVarMaterialLerpRate->Set(MaterialLerpRate, ECVF_SetByProjectSetting);
+	CVarDoorOpenSpeedScale->Set(DoorOpenSpeedScale, ECVF_SetByProjectSetting);
+	CVarDoorCloseSpeedScale->Set(DoorCloseSpeedScale, ECVF_SetByProjectSetting);
+	CVarDoorDelayScale->Set(DoorDelayScale, ECVF_SetByProjectSetting);
+	CVarDoorTickInterval->Set(DoorTickInterval, ECVF_SetByProjectSetting);
+	CVarDeferredInitBudgetMs->Set(DeferredInitBudgetMs, ECVF_SetByProjectSetting);
+	CVarGovernorBudgetMs->Set(GovernorBudgetMs, ECVF_SetByProjectSetting);
+	CVarGovernorNearDistance->Set(GovernorNearDistance, ECVF_SetByProjectSetting);
+
+	// Refresh right away rather than waiting for the sink, so the first frame already sees project values.
+	RefreshBuildingEscapeTuning();
+}
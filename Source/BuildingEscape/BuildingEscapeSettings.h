@@ -0,0 +1,155 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "BuildingEscapeSettings.generated.h"
+
+// Tuning values read by gameplay code. Refreshed from the be.* console variables whenever one of them changes,
+// so hot paths read a plain struct instead of looking up config or console variables every frame.
+struct BUILDINGESCAPE_API FBuildingEscapeTuning
+{
+	float InteractionReach = 200.f;
+	float InteractionTickInterval = 0.f;
+	float RotationLerpRate = 1.6f;
+	float RotationFadeOutThreshold = 15.f;
+	float RotationSnapThreshold = 0.4f;
+	float MaterialLerpRate = 0.8f;
+	float DoorOpenSpeedScale = 1.f;
+	float DoorCloseSpeedScale = 1.f;
+	float DoorDelayScale = 1.f;
+	float DoorTickInterval = 0.f;
+	float DeferredInitBudgetMs = 1.f;
+	float GovernorBudgetMs = 12.f;
+	float GovernorNearDistance = 1500.f;
+
+	// Return the current cached values.
+	static const FBuildingEscapeTuning& Get();
+
+	// Broadcast after the cached values change, e.g. so components can re-apply tick intervals.
+	static FSimpleMulticastDelegate& OnChanged();
+};
+
+// Project Settings > Game > Building Escape. These are the defaults for the be.* console variables,
+// which can then be changed live from the console.
+UCLASS(config=Game, defaultconfig, meta=(DisplayName="Building Escape"))
+class BUILDINGESCAPE_API UBuildingEscapeSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostInitProperties() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	UPROPERTY(config, EditAnyWhere, Category = "Interaction", meta = (ClampMin = "0"))
+	float InteractionReach = 200.f;
+
+	// Seconds between interaction ticks (trace, grab target, rotations). 0 ticks every frame.
+	UPROPERTY(config, EditAnyWhere, Category = "Interaction", meta = (ClampMin = "0"))
+	float InteractionTickInterval = 0.f;
+
+	UPROPERTY(config, EditAnyWhere, Category = "Rotatable Actors", meta = (ClampMin = "0"))
+	float RotationLerpRate = 1.6f;
+
+	// Degrees from the target rotation at which the grinding sound starts fading out.
+	UPROPERTY(config, EditAnyWhere, Category = "Rotatable Actors", meta = (ClampMin = "0"))
+	float RotationFadeOutThreshold = 15.f;
+
+	// Degrees from the target rotation at which the rotation snaps into place.
+	UPROPERTY(config, EditAnyWhere, Category = "Rotatable Actors", meta = (ClampMin = "0"))
+	float RotationSnapThreshold = 0.4f;
+
+	UPROPERTY(config, EditAnyWhere, Category = "Rotatable Actors", meta = (ClampMin = "0"))
+	float MaterialLerpRate = 0.8f;
+
+	// Multiplies every door's DoorOpenSpeed.
+	UPROPERTY(config, EditAnyWhere, Category = "Doors", meta = (ClampMin = "0"))
+	float DoorOpenSpeedScale = 1.f;
+
+	// Multiplies every door's DoorCloseSpeed.
+	UPROPERTY(config, EditAnyWhere, Category = "Doors", meta = (ClampMin = "0"))
+	float DoorCloseSpeedScale = 1.f;
+
+	// Multiplies every door's DoorOpenDelay and DoorCloseDelay.
+	UPROPERTY(config, EditAnyWhere, Category = "Doors", meta = (ClampMin = "0"))
+	float DoorDelayScale = 1.f;
+
+	// Seconds between door ticks. 0 ticks every frame.
+	UPROPERTY(config, EditAnyWhere, Category = "Doors", meta = (ClampMin = "0"))
+	float DoorTickInterval = 0.f;
+
+	// Milliseconds per frame spent running deferred component initialization (material instances, step masks, ...).
+	UPROPERTY(config, EditAnyWhere, Category = "Startup", meta = (ClampMin = "0"))
+	float DeferredInitBudgetMs = 1.f;
+
+	// Game thread milliseconds per frame the frame governor aims for before it cuts back low priority work. 0 turns it off.
+	UPROPERTY(config, EditAnyWhere, Category = "Frame Governor", meta = (ClampMin = "0"))
+	float GovernorBudgetMs = 12.f;
+
+	// Doors closer than this to the player, in cm, keep their normal tick interval under load.
+	UPROPERTY(config, EditAnyWhere, Category = "Frame Governor", meta = (ClampMin = "0"))
+	float GovernorNearDistance = 1500.f;
+
+	// Height of a tower floor, in cm. Generated and streamed floors are stacked this far apart.
+	UPROPERTY(config, EditAnyWhere, Category = "Tower", meta = (ClampMin = "1"))
+	float TowerFloorHeight = 650.f;
+
+	// Floors above the player kept generated or streamed in.
+	UPROPERTY(config, EditAnyWhere, Category = "Tower", meta = (ClampMin = "0"))
+	int32 TowerFloorsAhead = 2;
+
+	// Floors below the player kept generated or streamed in.
+	UPROPERTY(config, EditAnyWhere, Category = "Tower", meta = (ClampMin = "0"))
+	int32 TowerFloorsBehind = 1;
+
+	// Write performance counters and gameplay events as NDJSON. Also turned on by -Telemetry.
+	UPROPERTY(config, EditAnyWhere, Category = "Telemetry")
+	bool bEnableTelemetry = false;
+
+	// Seconds between counter samples.
+	UPROPERTY(config, EditAnyWhere, Category = "Telemetry", meta = (ClampMin = "0.1"))
+	float TelemetrySampleInterval = 1.f;
+
+	// Collector URL the batches are posted to, e.g. http://127.0.0.1:8080/telemetry. Empty writes Saved/Telemetry
+	// files instead. Overridden by -TelemetryEndpoint=URL.
+	UPROPERTY(config, EditAnyWhere, Category = "Telemetry")
+	FString TelemetryEndpoint;
+
+	// Size at which Telemetry.ndjson rotates, and how many files are kept.
+	UPROPERTY(config, EditAnyWhere, Category = "Telemetry", meta = (ClampMin = "1"))
+	int32 TelemetryMaxFileSizeKB = 1024;
+
+	UPROPERTY(config, EditAnyWhere, Category = "Telemetry", meta = (ClampMin = "1"))
+	int32 TelemetryMaxFiles = 5;
+
+	// Most rotatable actor grinding sounds and door sounds playing at once, across the whole world.
+	UPROPERTY(config, EditAnyWhere, Category = "Audio", meta = (ClampMin = "1"))
+	int32 MaxRotationSounds = 3;
+
+	UPROPERTY(config, EditAnyWhere, Category = "Audio", meta = (ClampMin = "1"))
+	int32 MaxDoorSounds = 2;
+
+	// One-shot sounds up to this many seconds are decoded once and kept as PCM; loops and longer sounds stream.
+	UPROPERTY(config, EditAnyWhere, Category = "Audio", meta = (ClampMin = "0"))
+	float DecodedSoundMaxDuration = 3.f;
+
+	// Memory the decoded sounds may take in total.
+	UPROPERTY(config, EditAnyWhere, Category = "Audio", meta = (ClampMin = "0"))
+	int32 DecodedSoundCacheKB = 4096;
+
+	// Level shown while the main level loads (EULA, startup widgets).
+	UPROPERTY(config, EditAnyWhere, Category = "Startup", meta = (AllowedClasses = "World"))
+	FSoftObjectPath LoadingScreenLevel;
+
+	// Level that starts loading in the background as soon as the loading screen level is up.
+	UPROPERTY(config, EditAnyWhere, Category = "Startup", meta = (AllowedClasses = "World"))
+	FSoftObjectPath MainLevel;
+
+private:
+	// Push these settings into the be.* console variables.
+	void ApplyToConsoleVariables() const;
+};
@@ -0,0 +1,110 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "CoreMinimal.h"
+#include "BuildingEscapeGameModeBase.h"
+#include "BuildingEscapeSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Level.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "Misc/AutomationTest.h"
+#include "SimulationHostSubsystem.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static const int32 NumTestSessions = 2;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBuildingEscapeSimulationHostTest, "BuildingEscape.SimulationHost.SessionsSideBySide",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBuildingEscapeSimulationHostTest::RunTest(const FString& Parameters)
+{
+	const FString SourcePackageName = GetDefault<UBuildingEscapeSettings>()->MainLevel.GetLongPackageName();
+	if (SourcePackageName.IsEmpty())
+	{
+		AddError(TEXT("No main level is set in the BuildingEscape settings."));
+		return false;
+	}
+
+	// Load and start the main level once per session, the way the simulation host does.
+	UGameInstance* GameInstances[NumTestSessions] = {};
+	UWorld* Worlds[NumTestSessions] = {};
+	APawn* Pawns[NumTestSessions] = {};
+	for (int32 i = 0; i < NumTestSessions; i++)
+	{
+		const int32 SessionIndex = i + 1;
+		GameInstances[i] = NewObject<UGameInstance>(GEngine);
+		GameInstances[i]->InitializeStandalone(*FString::Printf(TEXT("TowerSessionTest%d"), SessionIndex));
+
+		const FString SessionPackageName = USimulationHostSubsystem::MakeSessionPackageName(SourcePackageName, SessionIndex, 1);
+		LoadPackageAsync(SessionPackageName, nullptr, *SourcePackageName);
+		FlushAsyncLoading();
+		UPackage* SessionPackage = FindPackage(nullptr, *SessionPackageName);
+		UWorld* World = SessionPackage ? UWorld::FindWorldInPackage(SessionPackage) : nullptr;
+		if (!TestNotNull(*FString::Printf(TEXT("Session %d world"), SessionIndex), World)) {break;}
+
+		USimulationHostSubsystem::InitSessionWorld(GameInstances[i], World, SessionIndex, 1);
+		Worlds[i] = World;
+		TestNotNull(*FString::Printf(TEXT("Session %d navigation system"), SessionIndex), World->GetNavigationSystem());
+
+		ABuildingEscapeGameModeBase* GameMode = World->GetAuthGameMode<ABuildingEscapeGameModeBase>();
+		if (GameMode && GameMode->StartAutoplayer(nullptr))
+		{
+			Pawns[i] = ABuildingEscapeGameModeBase::GetTowerPlayer(World);
+		}
+		TestNotNull(*FString::Printf(TEXT("Session %d autoplayer pawn"), SessionIndex), Pawns[i]);
+		World->BeginPlay();
+	}
+
+	if (Worlds[0] && Worlds[1])
+	{
+		// Tick the sessions one after another, as the engine ticks its world contexts.
+		for (int32 Frame = 0; Frame < 30; Frame++)
+		{
+			for (UWorld* World : Worlds)
+			{
+				World->Tick(LEVELTICK_All, 1.f / 30.f);
+				World->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+			}
+		}
+
+		TestNotEqual(TEXT("Sessions have their own worlds"), Worlds[0], Worlds[1]);
+		TestNotEqual(TEXT("Sessions have their own tower players"), Pawns[0], Pawns[1]);
+		for (int32 i = 0; i < NumTestSessions; i++)
+		{
+			TestTrue(*FString::Printf(TEXT("Session %d player is in its own world"), i + 1), Pawns[i] && Pawns[i]->GetWorld() == Worlds[i]);
+		}
+
+		// Sublevels must load into packages of their own, never the source sublevel or another session's copy.
+		TSet<UPackage*> SessionLevelPackages[NumTestSessions];
+		for (int32 i = 0; i < NumTestSessions; i++)
+		{
+			for (ULevelStreaming* StreamingLevel : Worlds[i]->GetStreamingLevels())
+			{
+				ULevel* LoadedLevel = StreamingLevel ? StreamingLevel->GetLoadedLevel() : nullptr;
+				if (!LoadedLevel) {continue;}
+
+				UPackage* LevelPackage = LoadedLevel->GetOutermost();
+				TestNotEqual(*FString::Printf(TEXT("Session %d loads %s under its own name"), i + 1, *LevelPackage->GetName()),
+					LevelPackage->GetFName(), StreamingLevel->PackageNameToLoad);
+				SessionLevelPackages[i].Add(LevelPackage);
+			}
+		}
+		TestEqual(TEXT("Sessions share no sublevel packages"), SessionLevelPackages[0].Intersect(SessionLevelPackages[1]).Num(), 0);
+	}
+
+	for (UGameInstance* GameInstance : GameInstances)
+	{
+		if (!GameInstance) {continue;}
+		USimulationHostSubsystem::DestroySessionWorld(GameInstance);
+		GameInstance->Shutdown();
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,74 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "BuildingEscapeStartupTiming.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeSettings.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+	double LastMarkTime = 0.0;
+	double MapLoadStartTime = 0.0;
+	bool bHasMarkedFirstInteractiveFrame = false;
+	FDelegateHandle PostEngineInitHandle;
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+
+	double SecondsSinceLaunch()
+	{
+		return FPlatformTime::Seconds() - GStartTime;
+	}
+}
+
+void BuildingEscapeStartupTiming::Register()
+{
+	Mark(TEXT("Module startup"));
+
+	PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddLambda([]()
+	{
+		Mark(TEXT("Engine init"));
+	});
+
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddLambda([](const FString& MapName)
+	{
+		MapLoadStartTime = FPlatformTime::Seconds();
+		Mark(FString::Printf(TEXT("Load map %s started"), *MapName));
+	});
+
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddLambda([](UWorld* LoadedWorld)
+	{
+		const FString MapName = LoadedWorld ? LoadedWorld->GetMapName() : TEXT("(failed)");
+		Mark(FString::Printf(TEXT("Load map %s finished in %.3f s"), *MapName, FPlatformTime::Seconds() - MapLoadStartTime));
+	});
+}
+
+void BuildingEscapeStartupTiming::Unregister()
+{
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+}
+
+void BuildingEscapeStartupTiming::Mark(const FString& Phase)
+{
+	if (bHasMarkedFirstInteractiveFrame) {return;}
+
+	const double Now = SecondsSinceLaunch();
+	UE_LOG(LogStartupTiming, Log, TEXT("%8.3f s (+%.3f s) %s"), Now, Now - LastMarkTime, *Phase);
+	LastMarkTime = Now;
+}
+
+void BuildingEscapeStartupTiming::MarkFirstInteractiveFrame(const UWorld* World)
+{
+	if (bHasMarkedFirstInteractiveFrame || !World) {return;}
+	if (World->GetOutermost()->GetName() == GetDefault<UBuildingEscapeSettings>()->LoadingScreenLevel.GetLongPackageName()) {return;}
+
+	Mark(TEXT("First interactive frame"));
+	bHasMarkedFirstInteractiveFrame = true;
+	UE_LOG(LogStartupTiming, Log, TEXT("Cold start to playable: %.3f s"), SecondsSinceLaunch());
+}
@@ -0,0 +1,23 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+// Cold start timing, from process launch to the first frame the player can interact. Every phase is logged to
+// LogStartupTiming with the seconds since launch and since the previous mark.
+namespace BuildingEscapeStartupTiming
+{
+	// Subscribe to engine init and map load delegates. Called from the module's StartupModule.
+	void Register();
+	void Unregister();
+
+	// Log Phase with the time since launch and since the previous mark.
+	void Mark(const FString& Phase);
+
+	// Mark the first frame the player can interact in World and log a summary. Ignored for the loading screen level,
+	// and only the first call per process does anything.
+	void MarkFirstInteractiveFrame(const UWorld* World);
+}
@@ -0,0 +1,295 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "BuildingEscapeTelemetry.h"
+#include "Async/Async.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeFrameGovernor.h"
+#include "BuildingEscapeSettings.h"
+#include "Containers/Queue.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformProperties.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "RenderCore.h"
+#include "Templates/Atomic.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+	// Drains queued lines on its own thread and writes them out in batches.
+	class FTelemetryWriter : public FRunnable
+	{
+	public:
+		FTelemetryWriter(const FString& InEndpoint, int64 InMaxFileSize, int32 InMaxFiles)
+			: Endpoint(InEndpoint)
+			, MaxFileSize(InMaxFileSize)
+			, MaxFiles(InMaxFiles)
+		{
+			FilePath = FPaths::ProjectSavedDir() / TEXT("Telemetry") / TEXT("Telemetry.ndjson");
+			WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+			Thread = FRunnableThread::Create(this, TEXT("BuildingEscapeTelemetry"), 0, TPri_BelowNormal);
+		}
+
+		virtual ~FTelemetryWriter()
+		{
+			bIsStopping = true;
+			WakeEvent->Trigger();
+			if (Thread)
+			{
+				Thread->WaitForCompletion();
+				delete Thread;
+			}
+			FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		}
+
+		// Game thread only.
+		void Enqueue(FString&& Line)
+		{
+			Lines.Enqueue(MoveTemp(Line));
+		}
+
+		virtual uint32 Run() override
+		{
+			while (!bIsStopping)
+			{
+				// Stop wakes this thread early; that last batch must go to disk, as nothing will send it once the
+				// game thread is gone.
+				WakeEvent->Wait(FlushIntervalMs);
+				Flush(bIsStopping);
+			}
+			Flush(true);
+			return 0;
+		}
+
+	private:
+		void Flush(bool bIsFinal)
+		{
+			FString Batch;
+			FString Line;
+			while (Lines.Dequeue(Line))
+			{
+				Batch += Line;
+				Batch += TEXT("\n");
+			}
+			if (Batch.IsEmpty()) {return;}
+
+			// Requests are sent from the game thread, which is gone by the final flush; that batch goes to disk instead.
+			if (!Endpoint.IsEmpty() && !bIsFinal)
+			{
+				AsyncTask(ENamedThreads::GameThread, [Endpoint = Endpoint, Batch = MoveTemp(Batch)]()
+				{
+					TSharedRef<IHttpRequest> Request = FHttpModule::Get().CreateRequest();
+					Request->SetURL(Endpoint);
+					Request->SetVerb(TEXT("POST"));
+					Request->SetHeader(TEXT("Content-Type"), TEXT("application/x-ndjson"));
+					Request->SetContentAsString(Batch);
+					Request->ProcessRequest();
+				});
+				return;
+			}
+
+			RotateFiles(Batch.Len());
+			FFileHelper::SaveStringToFile(Batch, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append);
+		}
+
+		// Telemetry.ndjson becomes Telemetry_1.ndjson, _1 becomes _2, ... and the oldest is dropped.
+		void RotateFiles(int32 BatchSize) const
+		{
+			IFileManager& FileManager = IFileManager::Get();
+			const int64 FileSize = FileManager.FileSize(*FilePath);
+			if (FileSize < 0 || FileSize + BatchSize <= MaxFileSize) {return;}
+
+			const FString BasePath = FPaths::GetPath(FilePath) / FPaths::GetBaseFilename(FilePath);
+			FileManager.Delete(*FString::Printf(TEXT("%s_%d.ndjson"), *BasePath, MaxFiles - 1), false, false, true);
+			for (int32 i = MaxFiles - 2; i >= 1; i--)
+			{
+				FileManager.Move(*FString::Printf(TEXT("%s_%d.ndjson"), *BasePath, i + 1), *FString::Printf(TEXT("%s_%d.ndjson"), *BasePath, i), true, true, false, true);
+			}
+			if (MaxFiles > 1)
+			{
+				FileManager.Move(*FString::Printf(TEXT("%s_1.ndjson"), *BasePath), *FilePath, true, true, false, true);
+			}
+			else
+			{
+				FileManager.Delete(*FilePath, false, false, true);
+			}
+		}
+
+		static const uint32 FlushIntervalMs = 2000;
+
+		FString Endpoint;
+		FString FilePath;
+		int64 MaxFileSize;
+		int32 MaxFiles;
+		TQueue<FString, EQueueMode::Spsc> Lines;
+		FEvent* WakeEvent = nullptr;
+		FRunnableThread* Thread = nullptr;
+		TAtomic<bool> bIsStopping{false};
+	};
+
+	TUniquePtr<FTelemetryWriter> Writer;
+	bool bHasCheckedSettings = false;
+	FString SessionId;
+	double NextSampleTime = 0.0;
+	double MapLoadStartTime = 0.0;
+
+	// Accumulated since the last sample.
+	int32 Frames = 0;
+	double FrameMsTotal = 0.0;
+	float FrameMsMax = 0.f;
+	double GameThreadMsTotal = 0.0;
+	int32 Traces = 0;
+	int32 ActiveDoors = 0;
+	int32 RotatingObjects = 0;
+
+	FDelegateHandle EndFrameHandle;
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+
+	FString EscapeJson(const FString& Value)
+	{
+		return Value.Replace(TEXT("\\"), TEXT("\\\\")).Replace(TEXT("\""), TEXT("\\\""));
+	}
+
+	// Every line starts with its type, the session and seconds since launch.
+	void WriteLine(const TCHAR* Type, const FString& Fields)
+	{
+		if (!Writer) {return;}
+		Writer->Enqueue(FString::Printf(TEXT("{\"type\":\"%s\",\"session\":\"%s\",\"time\":%.3f,%s}"),
+			Type, *SessionId, FPlatformTime::Seconds() - GStartTime, *Fields));
+	}
+
+	void StartWriter()
+	{
+		bHasCheckedSettings = true;
+
+		const UBuildingEscapeSettings* Settings = GetDefault<UBuildingEscapeSettings>();
+		if (!Settings->bEnableTelemetry && !FParse::Param(FCommandLine::Get(), TEXT("Telemetry"))) {return;}
+
+		FString Endpoint = Settings->TelemetryEndpoint;
+		FParse::Value(FCommandLine::Get(), TEXT("TelemetryEndpoint="), Endpoint);
+
+		SessionId = FGuid::NewGuid().ToString(EGuidFormats::DigitsWithHyphens);
+		Writer = MakeUnique<FTelemetryWriter>(Endpoint, (int64)Settings->TelemetryMaxFileSizeKB * 1024, FMath::Max(1, Settings->TelemetryMaxFiles));
+		UE_LOG(LogBuildingEscape, Log, TEXT("Telemetry session %s writing to %s."), *SessionId, Endpoint.IsEmpty() ? TEXT("Saved/Telemetry") : *Endpoint);
+
+		WriteLine(TEXT("session"), FString::Printf(TEXT("\"build\":\"%s\",\"platform\":\"%s\",\"cpu\":\"%s\",\"gpu\":\"%s\",\"cores\":%d"),
+			*EscapeJson(FApp::GetBuildVersion()), *EscapeJson(ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName())),
+			*EscapeJson(FPlatformMisc::GetCPUBrand().TrimStartAndEnd()), *EscapeJson(FPlatformMisc::GetPrimaryGPUBrand()),
+			FPlatformMisc::NumberOfCoresIncludingHyperthreads()));
+	}
+
+	void Sample()
+	{
+		const float NumFrames = FMath::Max(1, Frames);
+		WriteLine(TEXT("sample"), FString::Printf(
+			TEXT("\"frames\":%d,\"frame_ms_avg\":%.2f,\"frame_ms_max\":%.2f,\"game_thread_ms_avg\":%.2f,\"traces_per_frame\":%.2f,\"active_doors\":%.2f,\"rotating_objects\":%.2f,\"governor_level\":%d"),
+			Frames, FrameMsTotal / NumFrames, FrameMsMax, GameThreadMsTotal / NumFrames, Traces / NumFrames,
+			ActiveDoors / NumFrames, RotatingObjects / NumFrames, BuildingEscapeFrameGovernor::GetLevel()));
+
+		Frames = 0;
+		FrameMsTotal = 0.0;
+		FrameMsMax = 0.f;
+		GameThreadMsTotal = 0.0;
+		Traces = 0;
+		ActiveDoors = 0;
+		RotatingObjects = 0;
+	}
+
+	void OnEndFrame()
+	{
+		// Settings are not loaded yet when the module starts, so look at them on the first frame.
+		if (!bHasCheckedSettings) {StartWriter();}
+		if (!Writer) {return;}
+
+		const float FrameMs = FApp::GetDeltaTime() * 1000.f;
+		Frames++;
+		FrameMsTotal += FrameMs;
+		FrameMsMax = FMath::Max(FrameMsMax, FrameMs);
+		GameThreadMsTotal += FPlatformTime::ToMilliseconds(GGameThreadTime);
+
+		const double Now = FPlatformTime::Seconds();
+		if (Now < NextSampleTime) {return;}
+		NextSampleTime = Now + FMath::Max(0.1f, GetDefault<UBuildingEscapeSettings>()->TelemetrySampleInterval);
+		Sample();
+	}
+}
+
+void BuildingEscapeTelemetry::Register()
+{
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&OnEndFrame);
+
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddLambda([](const FString& MapName)
+	{
+		MapLoadStartTime = FPlatformTime::Seconds();
+	});
+
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddLambda([](UWorld* LoadedWorld)
+	{
+		if (!LoadedWorld || MapLoadStartTime == 0.0) {return;}
+		RecordLevelLoad(LoadedWorld->GetOutermost()->GetName(), FPlatformTime::Seconds() - MapLoadStartTime);
+		MapLoadStartTime = 0.0;
+	});
+}
+
+void BuildingEscapeTelemetry::Unregister()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+
+	// Joins the writer thread, which writes out whatever is still queued.
+	if (Writer && Frames > 0) {Sample();}
+	Writer.Reset();
+}
+
+void BuildingEscapeTelemetry::CountTrace()
+{
+	Traces++;
+}
+
+void BuildingEscapeTelemetry::CountActiveDoor()
+{
+	ActiveDoors++;
+}
+
+void BuildingEscapeTelemetry::CountRotatingObject()
+{
+	RotatingObjects++;
+}
+
+void BuildingEscapeTelemetry::RecordGrab(float Seconds)
+{
+	if (!Writer) {return;}
+	WriteLine(TEXT("grab"), FString::Printf(TEXT("\"seconds\":%.3f"), Seconds));
+}
+
+void BuildingEscapeTelemetry::RecordPuzzleSolved(const AActor* Door, float Seconds)
+{
+	if (!Writer || !Door) {return;}
+	WriteLine(TEXT("puzzle_solved"), FString::Printf(TEXT("\"door\":\"%s\",\"map\":\"%s\",\"seconds\":%.3f"),
+		*EscapeJson(Door->GetName()), *EscapeJson(Door->GetWorld()->GetMapName()), Seconds));
+}
+
+void BuildingEscapeTelemetry::RecordLevelLoad(const FString& LevelName, float Seconds)
+{
+	if (!Writer) {return;}
+	WriteLine(TEXT("level_load"), FString::Printf(TEXT("\"level\":\"%s\",\"seconds\":%.3f"), *EscapeJson(LevelName), Seconds));
+}
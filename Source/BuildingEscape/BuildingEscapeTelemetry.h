@@ -0,0 +1,29 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+
+// Performance telemetry for comparing hardware in aggregate. When enabled (Project Settings > Building Escape >
+// Telemetry, or -Telemetry), the module's counters are sampled every TelemetrySampleInterval seconds and written,
+// together with gameplay events, as newline-delimited JSON. A background thread batches the lines and appends them
+// to Saved/Telemetry/Telemetry.ndjson (rotated at TelemetryMaxFileSizeKB), or posts them to TelemetryEndpoint
+// (-TelemetryEndpoint=URL) when one is set. The game thread only formats lines and queues them.
+namespace BuildingEscapeTelemetry
+{
+	// Subscribe to end of frame and map load delegates. Called from the module's StartupModule.
+	void Register();
+	void Unregister();
+
+	// Per frame counters, averaged over each sample.
+	void CountTrace();
+	void CountActiveDoor();
+	void CountRotatingObject();
+
+	// Events, written as their own lines.
+	void RecordGrab(float Seconds);
+	void RecordPuzzleSolved(const AActor* Door, float Seconds);
+	void RecordLevelLoad(const FString& LevelName, float Seconds);
+}
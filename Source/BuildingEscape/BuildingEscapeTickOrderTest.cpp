@@ -0,0 +1,78 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "DefaultCharacter.h"
+#include "DefaultHUD.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "InteractionComponent.h"
+#include "Misc/AutomationTest.h"
+#include "OpenDoor.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static bool HasTickPrerequisite(FTickFunction& TickFunction, const FTickFunction& Prerequisite)
+{
+	for (const FTickPrerequisite& Each : TickFunction.GetPrerequisites())
+	{
+		if (Each.PrerequisiteTickFunction == &Prerequisite) {return true;}
+	}
+	return false;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBuildingEscapeTickOrderTest, "BuildingEscape.TickOrder",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBuildingEscapeTickOrderTest::RunTest(const FString& Parameters)
+{
+	// A bare game world; actors are begun by hand, in the order a level would begin them.
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+
+	ADefaultCharacter* Character = World->SpawnActor<ADefaultCharacter>();
+	APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+	PlayerController->Possess(Character);
+
+	FActorSpawnParameters HUDSpawnParams;
+	HUDSpawnParams.Owner = PlayerController;
+	ADefaultHUD* HUD = World->SpawnActor<ADefaultHUD>(HUDSpawnParams);
+
+	AActor* Door = World->SpawnActor<AActor>();
+	USceneComponent* DoorRoot = NewObject<USceneComponent>(Door, TEXT("Root"));
+	Door->SetRootComponent(DoorRoot);
+	DoorRoot->RegisterComponent();
+	UOpenDoor* OpenDoor = NewObject<UOpenDoor>(Door, TEXT("OpenDoor"));
+	OpenDoor->RegisterComponent();
+
+	for (AActor* Actor : TArray<AActor*>{Character, PlayerController, HUD, Door})
+	{
+		Actor->DispatchBeginPlay();
+	}
+
+	// The interaction component probes from this frame's pawn position and control rotation.
+	UInteractionComponent* Interaction = Character->GetInteractionComponent();
+	FTickFunction& InteractionTick = Interaction->PrimaryComponentTick;
+	TestEqual(TEXT("InteractionComponent tick group"), (int32)InteractionTick.TickGroup, (int32)TG_PrePhysics);
+	TestTrue(TEXT("InteractionComponent ticks after its character"), HasTickPrerequisite(InteractionTick, Character->PrimaryActorTick));
+	TestTrue(TEXT("InteractionComponent ticks after CharacterMovement"),
+		HasTickPrerequisite(InteractionTick, Character->GetCharacterMovement()->PrimaryComponentTick));
+
+	// Doors read the rotations the player wrote this frame.
+	TestEqual(TEXT("OpenDoor tick group"), (int32)OpenDoor->PrimaryComponentTick.TickGroup, (int32)TG_PrePhysics);
+	TestTrue(TEXT("OpenDoor ticks after the player's InteractionComponent"), HasTickPrerequisite(OpenDoor->PrimaryComponentTick, InteractionTick));
+
+	// The reticle is drawn from DrawHUD after every tick group, so the HUD's own tick must not wait on anything.
+	TestFalse(TEXT("HUD tick does not wait on the InteractionComponent"), HasTickPrerequisite(HUD->PrimaryActorTick, InteractionTick));
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
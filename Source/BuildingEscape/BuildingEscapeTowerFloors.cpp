@@ -0,0 +1,34 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "BuildingEscapeTowerFloors.h"
+#include "BuildingEscapeSettings.h"
+
+namespace BuildingEscapeTowerFloors
+{
+	int32 GetFloorIndexAt(float Z, float BaseZ, int32 NumFloors)
+	{
+		if (NumFloors <= 0) {return INDEX_NONE;}
+
+		const int32 FloorIndex = FMath::FloorToInt((Z - BaseZ) / GetDefault<UBuildingEscapeSettings>()->TowerFloorHeight);
+		return FMath::Clamp(FloorIndex, 0, NumFloors - 1);
+	}
+
+	float GetFloorBaseZ(int32 FloorIndex, float BaseZ)
+	{
+		return BaseZ + FloorIndex * GetDefault<UBuildingEscapeSettings>()->TowerFloorHeight;
+	}
+
+	bool ShouldBeResident(int32 FloorIndex, int32 PlayerFloor, bool bIsResident)
+	{
+		const UBuildingEscapeSettings* Settings = GetDefault<UBuildingEscapeSettings>();
+		const int32 Slack = bIsResident ? 1 : 0;
+		return FloorIndex >= PlayerFloor - Settings->TowerFloorsBehind - Slack && FloorIndex <= PlayerFloor + Settings->TowerFloorsAhead + Slack;
+	}
+
+	int32 GetMaxResidentFloors()
+	{
+		const UBuildingEscapeSettings* Settings = GetDefault<UBuildingEscapeSettings>();
+		return Settings->TowerFloorsBehind + Settings->TowerFloorsAhead + 3;
+	}
+}
@@ -0,0 +1,26 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// The tower's floor layout and streaming window, shared by ATowerFloorGenerator and ATowerStreamingController so
+// generated and streamed floors agree on which floor the player is on and which floors stay resident. Floors are
+// TowerFloorHeight tall and stacked up from the owning actor; the window is TowerFloorsBehind floors below the
+// player to TowerFloorsAhead floors above (Project Settings > Building Escape > Tower).
+namespace BuildingEscapeTowerFloors
+{
+	// Return the floor at height Z in a tower of NumFloors floors starting at BaseZ, clamped to the tower.
+	// INDEX_NONE if the tower has no floors.
+	int32 GetFloorIndexAt(float Z, float BaseZ, int32 NumFloors);
+
+	// Return the height floor FloorIndex starts at.
+	float GetFloorBaseZ(int32 FloorIndex, float BaseZ);
+
+	// True if FloorIndex should be resident while the player is on PlayerFloor. Resident floors get one floor of
+	// slack on each side before they go, so walking along a floor boundary does not thrash.
+	bool ShouldBeResident(int32 FloorIndex, int32 PlayerFloor, bool bIsResident);
+
+	// Most floors resident at once, slack included.
+	int32 GetMaxResidentFloors();
+}
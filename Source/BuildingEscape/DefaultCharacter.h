@@ -5,47 +5,12 @@
 #include "CoreMinimal.h"
 #include "Engine/Texture2D.h"
 #include "GameFramework/Character.h"
+#include "InteractionComponent.h"
 #include "PaperSpriteComponent.h"
 #include "Templates/SubclassOf.h"
 #include "UObject/Class.h"
 #include "DefaultCharacter.generated.h"
 
-USTRUCT(BlueprintType)
-struct FObjectToRotate
-{
-	GENERATED_USTRUCT_BODY()
-
-
-	UPROPERTY()
-	AActor* ActorToRotate;
-
-	UPROPERTY()
-	bool bIsRotating;
-
-	UPROPERTY()
-	float OriginalActorYaw;
-
-	UPROPERTY()
-	float TargetRotation;
-
-	UPROPERTY()
-	FRotator ActorRotation;
-
-	UPROPERTY()
-	UAudioComponent* AudioComp;
-
-	// Default constructor.
-	FObjectToRotate()
-	{
-		ActorRotation = FRotator(-1.0f);
-		ActorToRotate = nullptr;
-		AudioComp = nullptr;
-		bIsRotating = false;
-		OriginalActorYaw = -1.0f;
-		TargetRotation = -1.0f;
-	}
-};
-
 UCLASS()
 class BUILDINGESCAPE_API ADefaultCharacter : public ACharacter
 {
@@ -61,28 +26,15 @@ public:
 	// Called to bind functionality to input
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
+	// Add and remove the head bob camera modifier as player controllers take and release this character.
+	virtual void PossessedBy(AController* NewController) override;
+	virtual void UnPossessed() override;
+
 	// Public Functions
 	void Interact();
 
-	// Public variables
-	UPROPERTY(BlueprintReadOnly)
-	AActor* ActorToGrab = nullptr;
-
-	UPROPERTY(BlueprintReadOnly)
-	FRotator PlayerViewPointRotation;
-
-	UPROPERTY(BlueprintReadOnly)
-	FVector PlayerViewPointLocation;
-
-	UPROPERTY(BlueprintReadWrite)
-	FVector LineTraceEnd;
-
-	UPROPERTY(BlueprintReadWrite)
-	TArray<FObjectToRotate> ObjectsToRotate;
-
-	// Return the ending point for line-tracing
-	UFUNCTION(BlueprintCallable)
-		FVector GetLineTraceEnd();
+	UInteractionComponent* GetInteractionComponent() const {return InteractionComponent;}
+	float GetPlayerMass() const {return PlayerMass;}
 
 protected:
 	// Called when the game starts or when spawned
@@ -93,35 +45,23 @@ protected:
 	void MoveBackward(float Value);
 	void MoveLeft(float Value);
 
-	void Grab();
-	void ReleaseGrabbed();
-	void CheckForObjectsToRotate();
-	void RotateObjects(float DeltaTime);
-
 private:
 	// Member Variables
-	bool bIsRotating = false;
-	bool bCanBeGrabbing = false;
 	float TurnSpeed = 45.f;
 	float LookUpSpeed = 45.f;
-	float TargetRotation;
-	float OriginalActorYaw;
-	FRotator ActorRotation;
 
 	UPROPERTY()
-	class UPhysicsHandleComponent* PhysicsHandle = nullptr;
+	class UGrabPhysicsHandleComponent* PhysicsHandle = nullptr;
 
-	UPROPERTY(EditAnyWhere)
-	float AmountToRotateActor = 90.f;
+	UPROPERTY(VisibleAnyWhere)
+	UInteractionComponent* InteractionComponent = nullptr;
 
 	UPROPERTY(EditAnyWhere)
 	float PlayerMass = 60.f;
 
+	// Passed on to the InteractionComponent. Zero or less follows be.Interaction.Reach.
 	UPROPERTY(EditAnyWhere)
-	float Reach = 200.f;
-
-	UPROPERTY(EditAnyWhere, meta = (category = "Rotatable Actors"))
-	int32 NumberOfRotatableActors = 4;
+	float Reach = 0.f;
 
 	UPROPERTY()
 	USceneComponent* GrabTransform = nullptr;
@@ -129,4 +69,12 @@ private:
 	UPROPERTY()
 	UPaperSpriteComponent* EToInteractSprite = nullptr;
 
+	// Added to the player's camera on possession. ABuildingEscapePlayerController drops the Blueprint's HeadBob_BP
+	// camera shake while it is there, so the bob is not applied twice.
+	UPROPERTY(EditAnyWhere, Category = "Camera")
+	TSubclassOf<class UCameraModifier> HeadBobModifierClass;
+
+	UPROPERTY()
+	class UCameraModifier* HeadBobModifier = nullptr;
+
 };
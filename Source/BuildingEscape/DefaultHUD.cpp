@@ -7,8 +7,6 @@
 #include "GameFramework/PlayerController.h"
 #include "UObject/ConstructorHelpers.h"
 
-#define OUT
-
 ADefaultHUD::ADefaultHUD()
 {
 	LoadAssets();
@@ -18,12 +16,13 @@ void ADefaultHUD::BeginPlay()
 {
 	Super::BeginPlay();
 
-	if (GEngine != 0)
+	// There is no viewport to size the reticle for when running headless (-nullrhi).
+	if (GEngine && GEngine->GameViewport && GEngine->GameViewport->Viewport)
 	{
 		ViewportSize = FVector2D(GEngine->GameViewport->Viewport->GetSizeXY());
 	}
 
-	PlayerPtr = Cast<ADefaultCharacter>(GetWorld()->GetFirstPlayerController()->GetCharacter());
+	PlayerPtr = Cast<ADefaultCharacter>(GetOwningPawn());
 }
 
 void ADefaultHUD::Tick(float DeltaTime)
@@ -52,34 +51,17 @@ void ADefaultHUD::UpdateReticle()
 		DrawTexture(CurrentReticleTexture, ViewportSize.X / 2, ViewportSize.Y / 2, 2.0f, 2.0f, 0, 0, 0, 0);
 	}
 
-	FCollisionQueryParams TraceParams(NAME_None, false, this);
-	FHitResult HitResult;
-	AActor* ActorHit = nullptr;
-
-	GetWorld()->LineTraceSingleByObjectType(
-		OUT HitResult,
-		PlayerPtr->PlayerViewPointLocation,
-		PlayerPtr->GetLineTraceEnd(),
-		FCollisionObjectQueryParams(ECollisionChannel::ECC_PhysicsBody),
-		TraceParams
-	);
-
-	ActorHit = HitResult.GetActor();
-	if (!ActorHit)
-	{
-		GetWorld()->LineTraceSingleByObjectType(
-			OUT HitResult,
-			PlayerPtr->PlayerViewPointLocation,
-			PlayerPtr->GetLineTraceEnd(),
-			FCollisionObjectQueryParams(ECollisionChannel::ECC_GameTraceChannel2),
-			TraceParams
-		);
+	// This runs from DrawHUD, after every tick group, so the InteractionComponent has already ticked this frame and the
+	// reticle just reads its latest probe.
+	UInteractionComponent* InteractionComponent = PlayerPtr ? PlayerPtr->GetInteractionComponent() : nullptr;
+	if (!InteractionComponent) {return;}
+	ensureMsgf(!InteractionComponent->TicksEveryFrame() || InteractionComponent->HasTickedThisFrame(),
+		TEXT("HUD drew before the player's InteractionComponent ticked."));
+	const bool bIsLookingAtInteractable = InteractionComponent->GetLastProbe().TargetType != EInteractionTargetType::None;
 
-		ActorHit = HitResult.GetActor();
-	}
 	if (InteractableReticleTexture && NotInteractableReticleTexture)
 	{
-		if (ActorHit)
+		if (bIsLookingAtInteractable)
 		{
 			CurrentReticleTexture = InteractableReticleTexture;
 		}
@@ -0,0 +1,93 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "DeferredInitSubsystem.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeGameModeBase.h"
+#include "BuildingEscapeSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/PlatformTime.h"
+
+UDeferredInitSubsystem* UDeferredInitSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UDeferredInitSubsystem>() : nullptr;
+}
+
+void UDeferredInitSubsystem::Enqueue(const FSimpleDelegate& Work, const FVector& Location)
+{
+	FDeferredInitItem& Item = PendingItems.AddDefaulted_GetRef();
+	Item.Work = Work;
+	Item.Location = Location;
+}
+
+void UDeferredInitSubsystem::EnqueueOrRun(const UObject* WorldContextObject, const FSimpleDelegate& Work, const FVector& Location)
+{
+	if (UDeferredInitSubsystem* DeferredInit = Get(WorldContextObject))
+	{
+		DeferredInit->Enqueue(Work, Location);
+		return;
+	}
+	Work.ExecuteIfBound();
+}
+
+bool UDeferredInitSubsystem::IsTickable() const
+{
+	return PendingItems.Num() > 0 && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UDeferredInitSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDeferredInitSubsystem, STATGROUP_Tickables);
+}
+
+int32 UDeferredInitSubsystem::FindHighestPriorityItem() const
+{
+	APawn* PlayerPawn = ABuildingEscapeGameModeBase::GetTowerPlayer(this);
+	if (!PlayerPawn) {return 0;}
+
+	// Items are few (one per puzzle component), so a linear scan each pick is cheaper than keeping a heap
+	// sorted against a player that keeps moving.
+	const FVector PlayerLocation = PlayerPawn->GetActorLocation();
+	int32 BestIndex = 0;
+	float BestDistSquared = TNumericLimits<float>::Max();
+	for (int32 i = 0; i < PendingItems.Num(); i++)
+	{
+		const float DistSquared = FVector::DistSquared(PendingItems[i].Location, PlayerLocation);
+		if (DistSquared < BestDistSquared)
+		{
+			BestDistSquared = DistSquared;
+			BestIndex = i;
+		}
+	}
+	return BestIndex;
+}
+
+void UDeferredInitSubsystem::Tick(float DeltaTime)
+{
+	FramesWithPendingItems++;
+
+	// Always run at least one item so the queue drains even with a zero budget.
+	const double EndTime = FPlatformTime::Seconds() + FBuildingEscapeTuning::Get().DeferredInitBudgetMs / 1000.0;
+	do
+	{
+		const int32 ItemIndex = FindHighestPriorityItem();
+		const FSimpleDelegate Work = PendingItems[ItemIndex].Work;
+		PendingItems.RemoveAtSwap(ItemIndex);
+
+		if (Work.ExecuteIfBound())
+		{
+			ItemsRun++;
+		}
+	}
+	while (PendingItems.Num() > 0 && FPlatformTime::Seconds() < EndTime);
+
+	if (PendingItems.Num() == 0)
+	{
+		UE_LOG(LogBuildingEscape, Log, TEXT("Deferred init ran %d items over %d frames."), ItemsRun, FramesWithPendingItems);
+		FramesWithPendingItems = 0;
+		ItemsRun = 0;
+	}
+}
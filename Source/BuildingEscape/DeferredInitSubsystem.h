@@ -0,0 +1,49 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "DeferredInitSubsystem.generated.h"
+
+struct FDeferredInitItem
+{
+	FSimpleDelegate Work;
+	FVector Location = FVector::ZeroVector;
+};
+
+// Spreads expensive component initialization over several frames instead of running it all in BeginPlay on the
+// first frame of the level. Work closest to the player runs first, within be.DeferredInit.BudgetMs per frame.
+UCLASS()
+class BUILDINGESCAPE_API UDeferredInitSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	// Return the deferred init subsystem of WorldContextObject's world, if there is one.
+	static UDeferredInitSubsystem* Get(const UObject* WorldContextObject);
+
+	// Queue Work to run on a later frame. Location is used to prioritize work near the player. Work bound to an
+	// object that is destroyed before it runs is skipped.
+	void Enqueue(const FSimpleDelegate& Work, const FVector& Location);
+
+	// Queue Work if WorldContextObject's world has a deferred init subsystem, otherwise run it right away.
+	static void EnqueueOrRun(const UObject* WorldContextObject, const FSimpleDelegate& Work, const FVector& Location);
+
+	int32 GetNumPending() const {return PendingItems.Num();}
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override {return GetWorld();}
+
+private:
+	int32 FindHighestPriorityItem() const;
+
+	// Member Variables
+	TArray<FDeferredInitItem> PendingItems;
+	int32 FramesWithPendingItems = 0;
+	int32 ItemsRun = 0;
+};
@@ -0,0 +1,116 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "GrabPhysicsHandleComponent.h"
+#include "Components/PrimitiveComponent.h"
+
+// Sets default values for this component's properties
+UGrabPhysicsHandleComponent::UGrabPhysicsHandleComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+
+	OnCalculateCustomPhysics.BindUObject(this, &UGrabPhysicsHandleComponent::SubstepUpdate);
+}
+
+// Called every frame
+void UGrabPhysicsHandleComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	// Skip UPhysicsHandleComponent's once-per-frame handle update; SubstepUpdate moves the handle instead.
+	UActorComponent::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	TrySleepReleasedBody(DeltaTime);
+
+	if (!GrabbedComponent || !bHasFrameTarget) {return;}
+
+	FrameDeltaTime = DeltaTime;
+	FrameTimeSimulated = 0.f;
+
+	// Custom physics callbacks only last one frame, so register for this frame's substeps.
+	// Without substepping enabled this is called once per frame with the full frame delta.
+	FBodyInstance* BodyInstance = GrabbedComponent->GetBodyInstance(GrabbedBoneName);
+	if (BodyInstance)
+	{
+		BodyInstance->AddCustomPhysics(OnCalculateCustomPhysics);
+	}
+}
+
+void UGrabPhysicsHandleComponent::SetFrameTarget(const FVector& TargetLocation, const FRotator& TargetRotation)
+{
+	const FTransform NewTarget(TargetRotation, TargetLocation);
+
+	// Start from the new target on a fresh grab so the object doesn't sweep in from an old position.
+	if (!bHasFrameTarget || LastGrabbedComponent.Get() != GrabbedComponent)
+	{
+		LastGrabbedComponent = GrabbedComponent;
+		PreviousFrameTarget = NewTarget;
+		FrameTarget = NewTarget;
+		SubstepTarget = NewTarget;
+		bHasFrameTarget = true;
+		return;
+	}
+
+	PreviousFrameTarget = FrameTarget;
+	if (FrameTarget.Equals(NewTarget, TargetTolerance)) {return;}
+	FrameTarget = NewTarget;
+}
+
+void UGrabPhysicsHandleComponent::SubstepUpdate(float DeltaTime, FBodyInstance* BodyInstance)
+{
+	// Called from the physics substep. The frame targets were written in TG_PrePhysics and are not touched again until physics ends.
+	FrameTimeSimulated += DeltaTime;
+	const float Alpha = FrameDeltaTime > 0.f ? FMath::Clamp(FrameTimeSimulated / FrameDeltaTime, 0.f, 1.f) : 1.f;
+
+	FTransform DesiredTarget;
+	DesiredTarget.Blend(PreviousFrameTarget, FrameTarget, Alpha);
+
+	// Honor the handle's interpolation settings, but per substep rather than per frame.
+	FTransform NewSubstepTarget = DesiredTarget;
+	if (bInterpolateTarget)
+	{
+		NewSubstepTarget.Blend(SubstepTarget, DesiredTarget, FMath::Clamp(InterpolationSpeed * DeltaTime, 0.f, 1.f));
+	}
+
+	if (NewSubstepTarget.Equals(SubstepTarget, KINDA_SMALL_NUMBER)) {return;}
+
+	SubstepTarget = NewSubstepTarget;
+	TargetTransform = DesiredTarget;
+	CurrentTransform = SubstepTarget;
+	UpdateHandleTransform(SubstepTarget);
+}
+
+void UGrabPhysicsHandleComponent::ReleaseComponent()
+{
+	// Watch the released body so it can be put to sleep as soon as it settles.
+	if (GrabbedComponent)
+	{
+		ReleasedComponent = GrabbedComponent;
+		ReleasedBoneName = GrabbedBoneName;
+		TimeSinceRelease = 0.f;
+	}
+
+	bHasFrameTarget = false;
+	LastGrabbedComponent = nullptr;
+
+	Super::ReleaseComponent();
+}
+
+void UGrabPhysicsHandleComponent::TrySleepReleasedBody(float DeltaTime)
+{
+	UPrimitiveComponent* Component = ReleasedComponent.Get();
+	if (!Component) {return;}
+
+	TimeSinceRelease += DeltaTime;
+	if (TimeSinceRelease > MaxSleepWaitTime || !Component->IsSimulatingPhysics(ReleasedBoneName) || !Component->RigidBodyIsAwake(ReleasedBoneName))
+	{
+		ReleasedComponent = nullptr;
+		return;
+	}
+
+	if (TimeSinceRelease >= MinSleepDelay
+		&& Component->GetPhysicsLinearVelocity(ReleasedBoneName).Size() < SleepLinearVelocity
+		&& Component->GetPhysicsAngularVelocityInDegrees(ReleasedBoneName).Size() < SleepAngularVelocity)
+	{
+		Component->PutRigidBodyToSleep(ReleasedBoneName);
+		ReleasedComponent = nullptr;
+	}
+}
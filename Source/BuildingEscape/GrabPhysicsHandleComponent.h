@@ -0,0 +1,66 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "PhysicsEngine/PhysicsHandleComponent.h"
+#include "GrabPhysicsHandleComponent.generated.h"
+
+/**
+ * Physics handle that moves its target once per physics substep instead of once per frame.
+ * The owner sets one target per frame and each substep interpolates from the previous frame's target toward it,
+ * so grabbed objects stay smooth when the game thread runs slowly. Released bodies are put to sleep as soon as they settle.
+ */
+UCLASS( ClassGroup=(Physics), meta=(BlueprintSpawnableComponent) )
+class BUILDINGESCAPE_API UGrabPhysicsHandleComponent : public UPhysicsHandleComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UGrabPhysicsHandleComponent();
+
+	// Called every frame
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	virtual void ReleaseComponent() override;
+
+	// Set where the grabbed object should be by the end of this frame. Must be called before physics runs (TG_PrePhysics).
+	void SetFrameTarget(const FVector& TargetLocation, const FRotator& TargetRotation);
+
+private:
+	void SubstepUpdate(float DeltaTime, FBodyInstance* BodyInstance);
+	void TrySleepReleasedBody(float DeltaTime);
+
+	// Member Variables
+	bool bHasFrameTarget = false;
+	float FrameDeltaTime = 0.f;
+	float FrameTimeSimulated = 0.f;
+	float TimeSinceRelease = 0.f;
+	FName ReleasedBoneName;
+	FTransform PreviousFrameTarget;
+	FTransform FrameTarget;
+	FTransform SubstepTarget;
+	FCalculateCustomPhysics OnCalculateCustomPhysics;
+	TWeakObjectPtr<UPrimitiveComponent> LastGrabbedComponent;
+	TWeakObjectPtr<UPrimitiveComponent> ReleasedComponent;
+
+	// Frame targets closer than this to the current one are ignored so a still view doesn't keep waking the body.
+	UPROPERTY(EditAnyWhere, Category = "Grab")
+	float TargetTolerance = 0.1f;
+
+	// Give a body released mid-air time to start falling before it can be put to sleep.
+	UPROPERTY(EditAnyWhere, Category = "Grab|Sleep")
+	float MinSleepDelay = 0.25f;
+
+	UPROPERTY(EditAnyWhere, Category = "Grab|Sleep")
+	float SleepLinearVelocity = 5.f;
+
+	UPROPERTY(EditAnyWhere, Category = "Grab|Sleep")
+	float SleepAngularVelocity = 10.f;
+
+	// Stop watching a released body after this many seconds and let the physics engine put it to sleep on its own.
+	UPROPERTY(EditAnyWhere, Category = "Grab|Sleep")
+	float MaxSleepWaitTime = 2.f;
+};
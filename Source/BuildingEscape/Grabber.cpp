@@ -1,112 +0,0 @@
-// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
-
-
-#include "Grabber.h"
-#include "Engine/World.h"
-#include "GameFramework/PlayerController.h"
-#include "Math/Rotator.h"
-
-#define OUT
-
-// Sets default values for this component's properties
-UGrabber::UGrabber()
-{
-	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
-	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
-}
-
-// Called when the game starts
-void UGrabber::BeginPlay()
-{
-	Super::BeginPlay();
-
-	FindPhysicsHandle();
-	SetupInputComponent();
-}
-
-void UGrabber::SetupInputComponent()
-{
-	InputComponent = GetOwner()->FindComponentByClass<UInputComponent>();
-
-	if (InputComponent)	
-	{	
-		InputComponent->BindAction("Grab", IE_Pressed, this, &UGrabber::Grab);
-		InputComponent->BindAction("Grab", IE_Released, this, &UGrabber::Release);
-	}
-}
-
-void UGrabber::FindPhysicsHandle()
-{
-	PhysicsHandle = GetOwner()->FindComponentByClass<UPhysicsHandleComponent>();
-
-	// Checking if owner of Grabber has a PhysicsHandle component since grabbing relies on the Physics Handle
-	if (!PhysicsHandle)
-	{
-		UE_LOG(LogTemp, Error, TEXT("%s has no PhysicsHandle component!"), *GetOwner()->GetName());
-	}
-}
-
-void UGrabber::Grab()
-{
-	FHitResult HitResult = GetFirstPhysicsBodyInReach();
-	UPrimitiveComponent* ComponentToGrab = HitResult.GetComponent();
-	AActor* ActorHit = HitResult.GetActor();
-
-	// If we hit something then attach the physics handle component
-	if (ActorHit)
-	{
-		if (!PhysicsHandle) {return;}
-		PhysicsHandle->GrabComponentAtLocation(ComponentToGrab, NAME_None, GetLineTraceEnd());
-	}
-}
-
-void UGrabber::Release()
-{
-	if (!PhysicsHandle) {return;}
-	PhysicsHandle->ReleaseComponent();
-}
-
-// Called every frame
-void UGrabber::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-	// If the physics handle is attached move the object that is grabbed
-	if (!PhysicsHandle) {return;}
-	if (PhysicsHandle->GrabbedComponent)
-	{
-		PhysicsHandle->SetTargetLocation(GetLineTraceEnd());
-	}
-}
-
-FHitResult UGrabber::GetFirstPhysicsBodyInReach()
-{
-	FHitResult Hit;
-	FCollisionQueryParams TraceParams(FName(TEXT("")), false, GetOwner());
-
-	// Ray-cast out to a certain distance (Reach)
-	GetWorld()->LineTraceSingleByObjectType(
-		OUT Hit,
-		PlayerViewPointLocation,
-		GetLineTraceEnd(),
-		FCollisionObjectQueryParams(ECollisionChannel::ECC_PhysicsBody),
-		TraceParams
-	);
-
-	AActor* ActorHit = Hit.GetActor();
-
-	if (ActorHit)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("The line trace hit: %s."), *ActorHit->GetName());
-	}
-
-	return Hit;
-}
-
-FVector UGrabber::GetLineTraceEnd()
-{
-	GetWorld()->GetFirstPlayerController()->GetPlayerViewPoint(OUT PlayerViewPointLocation, OUT PlayerViewPointRotation);
-
-	return LineTraceEnd = PlayerViewPointLocation + PlayerViewPointRotation.Vector() * Reach;
-}
@@ -0,0 +1,52 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "HeadBobCameraModifier.h"
+#include "Camera/CameraTypes.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarCameraHeadBob(
+	TEXT("be.Camera.HeadBob"),
+	1,
+	TEXT("Enable the camera head bob while walking. Set per platform in the [SystemSettings] section of <Platform>Engine.ini."),
+	ECVF_Scalability);
+
+bool UHeadBobCameraModifier::ModifyCamera(float DeltaTime, FMinimalViewInfo& InOutPOV)
+{
+	Super::ModifyCamera(DeltaTime, InOutPOV);
+
+	const float MovementAlpha = CVarCameraHeadBob.GetValueOnGameThread() != 0 ? GetMovementAlpha() : 0.f;
+	BobWeight = FMath::FInterpTo(BobWeight, MovementAlpha, DeltaTime, BlendSpeed);
+	if (BobWeight <= KINDA_SMALL_NUMBER)
+	{
+		BobPhase = 0.f;
+		return false;
+	}
+
+	// Walk faster, step faster.
+	BobPhase = FMath::Fmod(BobPhase + DeltaTime * BobFrequency * MovementAlpha * 2.f * PI, 2.f * PI);
+
+	float SinPhase;
+	float CosPhase;
+	FMath::SinCos(&SinPhase, &CosPhase, BobPhase);
+	const float StepCurve = FMath::Abs(SinPhase);
+
+	const FRotationMatrix ViewRotation(InOutPOV.Rotation);
+	InOutPOV.Location += ViewRotation.GetScaledAxis(EAxis::Z) * (StepCurve * VerticalAmplitude * BobWeight);
+	InOutPOV.Location += ViewRotation.GetScaledAxis(EAxis::Y) * (CosPhase * HorizontalAmplitude * BobWeight);
+	InOutPOV.Rotation.Roll += CosPhase * RollAmplitude * BobWeight;
+
+	return false;
+}
+
+float UHeadBobCameraModifier::GetMovementAlpha() const
+{
+	const ACharacter* Character = Cast<ACharacter>(GetViewTarget());
+	const UCharacterMovementComponent* Movement = Character ? Character->GetCharacterMovement() : nullptr;
+	if (!Movement || !Movement->IsMovingOnGround() || Movement->MaxWalkSpeed <= KINDA_SMALL_NUMBER) {return 0.f;}
+
+	return FMath::Clamp(Movement->Velocity.Size2D() / Movement->MaxWalkSpeed, 0.f, 1.f);
+}
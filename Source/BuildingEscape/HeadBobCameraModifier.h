@@ -0,0 +1,44 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera/CameraModifier.h"
+#include "HeadBobCameraModifier.generated.h"
+
+// Native head bob driven by the view target's movement speed. Replaces the camera shake HeadBob_BP played every tick.
+// The bob is a pair of sine/cosine curves evaluated directly, and can be turned off per platform with be.Camera.HeadBob.
+UCLASS()
+class BUILDINGESCAPE_API UHeadBobCameraModifier : public UCameraModifier
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ModifyCamera(float DeltaTime, struct FMinimalViewInfo& InOutPOV) override;
+
+private:
+	// Return the view target's planar speed as a fraction of its max walk speed, or 0 when it is not walking.
+	float GetMovementAlpha() const;
+
+	// Member Variables
+	float BobPhase = 0.f;
+	float BobWeight = 0.f;
+
+	// Full bob cycles (two steps) per second at max walk speed.
+	UPROPERTY(EditAnyWhere, Category = "Head Bob")
+	float BobFrequency = 1.f;
+
+	// Peak vertical offset in cm. The vertical bob runs at twice the frequency of the sideways bob, once per step.
+	UPROPERTY(EditAnyWhere, Category = "Head Bob")
+	float VerticalAmplitude = 2.f;
+
+	UPROPERTY(EditAnyWhere, Category = "Head Bob")
+	float HorizontalAmplitude = 1.f;
+
+	UPROPERTY(EditAnyWhere, Category = "Head Bob")
+	float RollAmplitude = 0.3f;
+
+	// How quickly the bob fades in when starting to move and out when stopping.
+	UPROPERTY(EditAnyWhere, Category = "Head Bob")
+	float BlendSpeed = 6.f;
+};
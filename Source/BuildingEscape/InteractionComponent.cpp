@@ -0,0 +1,413 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "InteractionComponent.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeDebug.h"
+#include "BuildingEscapeFrameGovernor.h"
+#include "BuildingEscapeSettings.h"
+#include "BuildingEscapeStartupTiming.h"
+#include "BuildingEscapeTelemetry.h"
+#include "Components/AudioComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "DeferredInitSubsystem.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "GrabPhysicsHandleComponent.h"
+#include "PropPoolSubsystem.h"
+#include "RotationCommitSubsystem.h"
+#include "RotationStepComponent.h"
+#include "SoundCacheSubsystem.h"
+
+#define OUT
+
+// Sets default values for this component's properties
+UInteractionComponent::UInteractionComponent()
+{
+	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
+	// off to improve performance if you don't need them.
+	PrimaryComponentTick.bCanEverTick = true;
+
+	// Probe and rotate before physics, after the owner has moved, so doors and the HUD read this frame's results.
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+// Called when the game starts
+void UInteractionComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// The view point comes from the owner, so wait for it (and its movement, which waits for the controller) to tick.
+	AddTickPrerequisiteActor(GetOwner());
+	if (ACharacter* Character = Cast<ACharacter>(GetOwner()))
+	{
+		AddTickPrerequisiteComponent(Character->GetCharacterMovement());
+	}
+
+	PhysicsHandle = GetOwner()->FindComponentByClass<UGrabPhysicsHandleComponent>();
+	if (!PhysicsHandle)
+	{
+		UE_LOG(LogInteraction, Error, TEXT("%s has an InteractionComponent but no GrabPhysicsHandle component!"), *GetOwner()->GetName());
+	}
+
+	ApplyTuning();
+	TuningChangedHandle = FBuildingEscapeTuning::OnChanged().AddUObject(this, &UInteractionComponent::ApplyTuning);
+
+	if (URotationCommitSubsystem* RotationCommit = URotationCommitSubsystem::Get(this))
+	{
+		RotationCommit->AddWriter(this);
+	}
+	if (UPropPoolSubsystem* PropPool = UPropPoolSubsystem::Get(this))
+	{
+		PropReleasedHandle = PropPool->OnReleased.AddUObject(this, &UInteractionComponent::OnPropReleased);
+	}
+
+	UDeferredInitSubsystem::EnqueueOrRun(this, FSimpleDelegate::CreateUObject(this, &UInteractionComponent::InitializeDeferred), GetOwner()->GetActorLocation());
+}
+
+void UInteractionComponent::InitializeDeferred()
+{
+	// Fill ObjectsToRotate with "blank" FObjectToRotate structs.
+	ObjectsToRotate.Init(FObjectToRotate(), NumberOfRotatableActors);
+
+	bIsReady = true;
+	BuildingEscapeStartupTiming::MarkFirstInteractiveFrame(GetWorld());
+}
+
+void UInteractionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FBuildingEscapeTuning::OnChanged().Remove(TuningChangedHandle);
+	if (URotationCommitSubsystem* RotationCommit = URotationCommitSubsystem::Get(this))
+	{
+		RotationCommit->RemoveWriter(this);
+	}
+	if (UPropPoolSubsystem* PropPool = UPropPoolSubsystem::Get(this))
+	{
+		PropPool->OnReleased.Remove(PropReleasedHandle);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UInteractionComponent::TicksEveryFrame() const
+{
+	return IsComponentTickEnabled() && GetComponentTickInterval() <= 0.f && !GetWorld()->IsPaused();
+}
+
+void UInteractionComponent::ApplyTuning()
+{
+	SetComponentTickInterval(FBuildingEscapeTuning::Get().InteractionTickInterval);
+	UpdateGrabTransformLocation();
+}
+
+void UInteractionComponent::SetReach(float NewReach)
+{
+	Reach = NewReach;
+	UpdateGrabTransformLocation();
+}
+
+float UInteractionComponent::GetReach() const
+{
+	return Reach > 0.f ? Reach : FBuildingEscapeTuning::Get().InteractionReach;
+}
+
+void UInteractionComponent::UpdateGrabTransformLocation()
+{
+	if (!GrabTransform) {return;}
+
+	// Grabbed objects are held at the end of the reach, so the grab position sits there too.
+	FVector GrabLocation = GrabTransform->GetRelativeLocation();
+	GrabLocation.X = GetReach();
+	GrabTransform->SetRelativeLocation(GrabLocation);
+}
+
+// Called every frame
+void UInteractionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// The probe only feeds the reticle between interactions, and Interact traces again anyway if it is stale.
+	TickFrame = GFrameCounter;
+	if (GFrameCounter - ProbeFrame >= (uint64)BuildingEscapeFrameGovernor::GetProbeFrameInterval())
+	{
+		UpdateProbe();
+	}
+
+	// If the PhysicsHandle is attached, give it this frame's target location and target rotation (basically move grabbed object).
+	// The handle interpolates toward it on every physics substep.
+	if (IsGrabbing() && GrabTransform)
+	{
+		PhysicsHandle->SetFrameTarget(LineTraceEnd, GrabTransform->GetComponentRotation());
+	}
+
+	RotateObjects(DeltaTime);
+}
+
+FVector UInteractionComponent::GetLineTraceEnd()
+{
+	APawn* OwningPawn = Cast<APawn>(GetOwner());
+	AController* Controller = OwningPawn ? OwningPawn->GetController() : nullptr;
+	if (Controller)
+	{
+		Controller->GetPlayerViewPoint(OUT PlayerViewPointLocation, OUT PlayerViewPointRotation);
+	}
+
+	return LineTraceEnd = PlayerViewPointLocation + PlayerViewPointRotation.Vector() * GetReach();
+}
+
+void UInteractionComponent::UpdateProbe()
+{
+	ProbeFrame = GFrameCounter;
+	Probe = FInteractionProbe();
+	BuildingEscapeTelemetry::CountTrace();
+	GetLineTraceEnd();
+
+	// One trace against both grabbable and rotatable objects; the closest hit wins.
+	FCollisionObjectQueryParams ObjectParams;
+	ObjectParams.AddObjectTypesToQuery(ECollisionChannel::ECC_PhysicsBody);
+	ObjectParams.AddObjectTypesToQuery(ECollisionChannel::ECC_GameTraceChannel2);
+	FCollisionQueryParams TraceParams(NAME_None, false, GetOwner());
+	FHitResult HitResult;
+
+	GetWorld()->LineTraceSingleByObjectType(
+		OUT HitResult,
+		PlayerViewPointLocation,
+		LineTraceEnd,
+		ObjectParams,
+		TraceParams
+	);
+
+#if BUILDINGESCAPE_DEBUG_DRAW
+	if (BuildingEscapeDebug::IsDrawEnabled(BuildingEscapeDebug::Traces))
+	{
+		DrawDebugLine(GetWorld(), PlayerViewPointLocation, LineTraceEnd, HitResult.bBlockingHit ? FColor::Green : FColor::Red);
+		if (HitResult.bBlockingHit)
+		{
+			DrawDebugPoint(GetWorld(), HitResult.ImpactPoint, 8.f, FColor::Green);
+		}
+	}
+#endif
+
+	UPrimitiveComponent* ComponentHit = HitResult.GetComponent();
+	if (!HitResult.GetActor() || !ComponentHit) {return;}
+
+	Probe.HitActor = HitResult.GetActor();
+	Probe.HitComponent = ComponentHit;
+	Probe.BoneName = HitResult.BoneName;
+	Probe.TargetType = ComponentHit->GetCollisionObjectType() == ECollisionChannel::ECC_PhysicsBody ? EInteractionTargetType::Grabbable : EInteractionTargetType::Rotatable;
+
+	UE_LOG(LogInteraction, Verbose, TEXT("The line trace hit: %s."), *Probe.HitActor->GetName());
+}
+
+const FInteractionProbe& UInteractionComponent::GetProbe()
+{
+	if (ProbeFrame != GFrameCounter)
+	{
+		UpdateProbe();
+	}
+	return Probe;
+}
+
+bool UInteractionComponent::IsLookingAtInteractable()
+{
+	return GetProbe().TargetType != EInteractionTargetType::None;
+}
+
+bool UInteractionComponent::IsGrabbing() const
+{
+	return PhysicsHandle && PhysicsHandle->GrabbedComponent;
+}
+
+bool UInteractionComponent::IsRotating(const AActor* Actor) const
+{
+	for (const FObjectToRotate& ObjectToRotate : ObjectsToRotate)
+	{
+		if (ObjectToRotate.ActorToRotate == Actor) {return ObjectToRotate.bIsRotating;}
+	}
+	return false;
+}
+
+void UInteractionComponent::Interact()
+{
+	if (!bIsReady) {return;}
+
+	if (IsGrabbing())
+	{
+		ReleaseGrabbed();
+		return;
+	}
+
+	const FInteractionProbe& CurrentProbe = GetProbe();
+	if (CurrentProbe.TargetType == EInteractionTargetType::Rotatable)
+	{
+		RotateActor(CurrentProbe.HitActor);
+	}
+	else if (CurrentProbe.TargetType == EInteractionTargetType::Grabbable)
+	{
+		Grab();
+	}
+}
+
+void UInteractionComponent::Grab()
+{
+	UPrimitiveComponent* ComponentToGrab = Probe.HitComponent;
+	if (Probe.HitActor && PhysicsHandle && ComponentToGrab)
+	{
+		ComponentToGrab->SetCollisionResponseToChannel(ECC_Pawn, ECR_Ignore);
+		if (GrabTransform)
+		{
+			GrabTransform->SetWorldRotation(ComponentToGrab->GetComponentRotation());
+		}
+		PhysicsHandle->GrabComponentAtLocationWithRotation(ComponentToGrab, Probe.BoneName, LineTraceEnd, ComponentToGrab->GetComponentRotation());
+		GrabStartTime = GetWorld()->GetTimeSeconds();
+	}
+}
+
+void UInteractionComponent::ReleaseGrabbed()
+{
+	PhysicsHandle->GrabbedComponent->SetCollisionResponseToChannel(ECC_Pawn, ECR_Block);
+	PhysicsHandle->ReleaseComponent();
+	BuildingEscapeTelemetry::RecordGrab(GetWorld()->GetTimeSeconds() - GrabStartTime);
+}
+
+void UInteractionComponent::RotateActor(AActor* ActorHit)
+{
+	if (!ActorHit) {return;}
+
+	bool bShouldMakeNewStruct = true;
+	// Loop through all ObjectsToRotate and check if any new objects need to be added to the array or if any existing objects need values updated.
+	for (int32 i = 0; i < ObjectsToRotate.Num(); i++)
+	{
+		// Check if the actor of the struct at the current index is a nullptr.
+		// If not check if the ActorHit is equal to the actor of the struct at the current index;
+		if (!ObjectsToRotate[i].ActorToRotate)
+		{
+			// Check if the value of ActorHit is in the array already.
+			// Based on that check we will know if we should make a new struct in this current iteration of the "i" for loop.
+			for (int32 j = 0; j < ObjectsToRotate.Num(); j++)
+			{
+				if (ActorHit == ObjectsToRotate[j].ActorToRotate)
+				{
+					bShouldMakeNewStruct = false;
+					break; // <-- Get out of current loop.
+				}
+			}
+		}
+		else if (ActorHit == ObjectsToRotate[i].ActorToRotate)
+		{
+			// Do not make a new struct in the current iteration of the "i" for loop.
+			bShouldMakeNewStruct = false;
+		}
+
+		if (!ObjectsToRotate[i].bIsRotating && ActorHit == ObjectsToRotate[i].ActorToRotate)
+		{
+			// Update struct at current index in ObjectsToRotate array.
+			ObjectsToRotate[i].ActorRotation = ObjectsToRotate[i].ActorToRotate->GetActorRotation();
+			ObjectsToRotate[i].OriginalActorYaw = ObjectsToRotate[i].ActorRotation.Yaw;
+			ObjectsToRotate[i].TargetRotation = ObjectsToRotate[i].OriginalActorYaw + AmountToRotateActor;
+			ObjectsToRotate[i].bIsRotating = true;
+			
+			// Play sound effect, picking up the previous rotation's sound if it is still fading out.
+			ObjectsToRotate[i].bIsSoundFadingOut = false;
+			USoundCacheSubsystem::PlayOrResume(ObjectsToRotate[i].AudioComp);
+		}
+		else if (bShouldMakeNewStruct && !ObjectsToRotate[i].bIsRotating && !ObjectsToRotate[i].ActorToRotate)
+		{
+			// Set up new struct and place the new struct in ObjectsToRotate array at the current index.
+			FObjectToRotate ObjectToRotateStruct;
+			ObjectToRotateStruct.ActorToRotate = ActorHit;
+			ObjectToRotateStruct.AudioComp = ActorHit->FindComponentByClass<UAudioComponent>();
+			if (USoundCacheSubsystem* SoundCache = USoundCacheSubsystem::Get(this))
+			{
+				SoundCache->RegisterAudioComponent(ObjectToRotateStruct.AudioComp, ESoundCacheGroup::Rotation);
+			}
+			ObjectToRotateStruct.StepComp = URotationStepComponent::FindOrAddTo(ActorHit, AmountToRotateActor);
+			ObjectToRotateStruct.ActorRotation = ObjectToRotateStruct.ActorToRotate->GetActorRotation();
+			ObjectToRotateStruct.OriginalActorYaw = ObjectToRotateStruct.ActorRotation.Yaw;
+			ObjectToRotateStruct.TargetRotation = ObjectToRotateStruct.OriginalActorYaw + AmountToRotateActor;
+			ObjectToRotateStruct.bIsRotating = true;
+			ObjectsToRotate[i] = ObjectToRotateStruct;
+			
+			// Play sound effect.
+			USoundCacheSubsystem::PlayOrResume(ObjectsToRotate[i].AudioComp);
+		}
+		else if (ActorHit == ObjectsToRotate[i].ActorToRotate && ObjectsToRotate[i].bIsRotating
+		&& FMath::RoundToFloat(ObjectsToRotate[i].ActorRotation.Yaw) != FMath::RoundToFloat(ObjectsToRotate[i].OriginalActorYaw))
+		{
+			// Add AmountToRotateObject to the target rotation of the current ActorToRotate because the player
+			// interacted with the object while it was rotating.
+			ObjectsToRotate[i].TargetRotation += AmountToRotateActor;
+
+			// Keep the sound going, bringing it back if it had started fading out.
+			ObjectsToRotate[i].bIsSoundFadingOut = false;
+			USoundCacheSubsystem::PlayOrResume(ObjectsToRotate[i].AudioComp);
+		}
+	}
+}
+
+void UInteractionComponent::RotateObjects(float DeltaTime)
+{
+	const FBuildingEscapeTuning& Tuning = FBuildingEscapeTuning::Get();
+
+	// Loop through all the rotatable actors, lerp their rotations, and set their rotations.
+	for (int32 i = 0; i < ObjectsToRotate.Num(); i++)
+	{
+		if (ObjectsToRotate.Num() != -1 && ObjectsToRotate[i].bIsRotating)
+		{
+			BuildingEscapeTelemetry::CountRotatingObject();
+
+			// Lerp the actor's rotation.
+			ObjectsToRotate[i].ActorRotation.Yaw = FMath::Lerp(ObjectsToRotate[i].ActorRotation.Yaw, ObjectsToRotate[i].TargetRotation, Tuning.RotationLerpRate * DeltaTime);
+
+			// Set the actor's rotation. Applied after every writer has ticked this frame.
+			URotationCommitSubsystem::CommitRotation(ObjectsToRotate[i].ActorToRotate, ObjectsToRotate[i].ActorRotation, ETeleportType::TeleportPhysics);
+
+			// Fade sound effect, once per rotation rather than restarting the fade every tick.
+			if (ObjectsToRotate[i].AudioComp && !ObjectsToRotate[i].bIsSoundFadingOut
+			&& FMath::Abs(ObjectsToRotate[i].TargetRotation - ObjectsToRotate[i].ActorRotation.Yaw) < Tuning.RotationFadeOutThreshold)
+			{
+				ObjectsToRotate[i].AudioComp->FadeOut(1.0f, 0.0f);
+				ObjectsToRotate[i].bIsSoundFadingOut = true;
+			}
+
+			// Snap actor's rotation so lerp doesn't go continuously.
+			if (FMath::Abs(ObjectsToRotate[i].TargetRotation - ObjectsToRotate[i].ActorRotation.Yaw) < Tuning.RotationSnapThreshold)
+			{
+				ObjectsToRotate[i].ActorRotation.Yaw = ObjectsToRotate[i].TargetRotation;
+				URotationCommitSubsystem::CommitRotation(ObjectsToRotate[i].ActorToRotate, ObjectsToRotate[i].ActorRotation, ETeleportType::TeleportPhysics);
+				ObjectsToRotate[i].bIsRotating = false;
+
+				// Commit the finished rotation as the actor's authoritative step index.
+				if (ObjectsToRotate[i].StepComp)
+				{
+					ObjectsToRotate[i].StepComp->SetYawStepFromYaw(ObjectsToRotate[i].TargetRotation);
+				}
+
+				// Stop sound effect
+				if (ObjectsToRotate[i].AudioComp)
+				{
+					ObjectsToRotate[i].AudioComp->Stop();
+				}
+			}
+		}
+	}
+}
+
+void UInteractionComponent::OnPropReleased(AActor* Actor)
+{
+	// A released actor goes dormant and comes back somewhere else, so stop turning it and free its slot.
+	for (FObjectToRotate& ObjectToRotate : ObjectsToRotate)
+	{
+		if (ObjectToRotate.ActorToRotate != Actor) {continue;}
+
+		if (ObjectToRotate.AudioComp)
+		{
+			ObjectToRotate.AudioComp->Stop();
+		}
+		ObjectToRotate = FObjectToRotate();
+	}
+}
@@ -0,0 +1,192 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "InteractionComponent.generated.h"
+
+class USceneComponent;
+
+UENUM(BlueprintType)
+enum class EInteractionTargetType : uint8
+{
+	None,
+	Grabbable,
+	Rotatable
+};
+
+USTRUCT(BlueprintType)
+struct FInteractionProbe
+{
+	GENERATED_USTRUCT_BODY()
+
+
+	UPROPERTY(BlueprintReadOnly)
+	AActor* HitActor;
+
+	UPROPERTY(BlueprintReadOnly)
+	class UPrimitiveComponent* HitComponent;
+
+	UPROPERTY(BlueprintReadOnly)
+	FName BoneName;
+
+	UPROPERTY(BlueprintReadOnly)
+	EInteractionTargetType TargetType;
+
+	// Default constructor.
+	FInteractionProbe()
+	{
+		HitActor = nullptr;
+		HitComponent = nullptr;
+		BoneName = NAME_None;
+		TargetType = EInteractionTargetType::None;
+	}
+};
+
+USTRUCT(BlueprintType)
+struct FObjectToRotate
+{
+	GENERATED_USTRUCT_BODY()
+
+
+	UPROPERTY()
+	AActor* ActorToRotate;
+
+	UPROPERTY()
+	bool bIsRotating;
+
+	UPROPERTY()
+	float OriginalActorYaw;
+
+	UPROPERTY()
+	float TargetRotation;
+
+	UPROPERTY()
+	FRotator ActorRotation;
+
+	UPROPERTY()
+	class UAudioComponent* AudioComp;
+
+	UPROPERTY()
+	bool bIsSoundFadingOut;
+
+	UPROPERTY()
+	class URotationStepComponent* StepComp;
+
+	// Default constructor.
+	FObjectToRotate()
+	{
+		ActorRotation = FRotator(-1.0f);
+		ActorToRotate = nullptr;
+		AudioComp = nullptr;
+		bIsSoundFadingOut = false;
+		StepComp = nullptr;
+		bIsRotating = false;
+		OriginalActorYaw = -1.0f;
+		TargetRotation = -1.0f;
+	}
+};
+
+// Owns everything the player can do by looking at something: grabbing physics bodies, rotating rotatable actors and
+// the reticle query. It runs one line trace per frame and everything else (Interact, the HUD) reads the cached result.
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class BUILDINGESCAPE_API UInteractionComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UInteractionComponent();
+
+	// Called every frame
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Grab, release or rotate whatever the player is looking at. Does nothing until the component is ready.
+	void Interact();
+
+	// False until the deferred part of BeginPlay has run.
+	bool IsReady() const {return bIsReady;}
+
+	// Tick order checks: anything that ticks after this component can expect it to have ticked this frame
+	// whenever the component ticks every frame.
+	bool HasTickedThisFrame() const {return TickFrame == GFrameCounter;}
+	bool TicksEveryFrame() const;
+
+	// Set the scene component whose rotation grabbed objects follow.
+	void SetGrabTransform(USceneComponent* NewGrabTransform) {GrabTransform = NewGrabTransform;}
+
+	// Override how far the player can reach, in cm. Zero or less follows be.Interaction.Reach.
+	void SetReach(float NewReach);
+	float GetReach() const;
+
+	// Return this frame's probe, tracing first if it has not run yet this frame.
+	const FInteractionProbe& GetProbe();
+
+	// Return the latest probe without tracing. Under load the frame governor spaces out the probes this
+	// component runs from its tick, so this can be a few frames old.
+	const FInteractionProbe& GetLastProbe() const {return Probe;}
+
+	UFUNCTION(BlueprintCallable)
+	bool IsLookingAtInteractable();
+
+	UFUNCTION(BlueprintCallable)
+	bool IsGrabbing() const;
+
+	// True while Actor is still turning towards the rotation the last Interact asked for.
+	bool IsRotating(const AActor* Actor) const;
+
+	// Return the ending point for line-tracing
+	UFUNCTION(BlueprintCallable)
+	FVector GetLineTraceEnd();
+
+	UPROPERTY(BlueprintReadOnly)
+	FRotator PlayerViewPointRotation;
+
+	UPROPERTY(BlueprintReadOnly)
+	FVector PlayerViewPointLocation;
+
+	UPROPERTY(BlueprintReadOnly)
+	FVector LineTraceEnd;
+
+	UPROPERTY(BlueprintReadOnly)
+	TArray<FObjectToRotate> ObjectsToRotate;
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	void ApplyTuning();
+	void UpdateGrabTransformLocation();
+	void InitializeDeferred();
+	void UpdateProbe();
+	void Grab();
+	void ReleaseGrabbed();
+	void RotateActor(AActor* ActorHit);
+	void RotateObjects(float DeltaTime);
+	void OnPropReleased(AActor* Actor);
+
+	// Member Variables
+	bool bIsReady = false;
+	uint64 ProbeFrame = 0;
+	uint64 TickFrame = 0;
+	float GrabStartTime = 0.f;
+	float Reach = 0.f;
+	FInteractionProbe Probe;
+	FDelegateHandle TuningChangedHandle;
+	FDelegateHandle PropReleasedHandle;
+
+	UPROPERTY()
+	class UGrabPhysicsHandleComponent* PhysicsHandle = nullptr;
+
+	UPROPERTY()
+	USceneComponent* GrabTransform = nullptr;
+
+	UPROPERTY(EditAnyWhere)
+	float AmountToRotateActor = 90.f;
+
+	UPROPERTY(EditAnyWhere, meta = (category = "Rotatable Actors"))
+	int32 NumberOfRotatableActors = 4;
+};
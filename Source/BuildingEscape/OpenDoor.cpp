@@ -2,15 +2,28 @@
 
 
 #include "OpenDoor.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeGameModeBase.h"
+#include "BuildingEscapeDebug.h"
+#include "BuildingEscapeFrameGovernor.h"
+#include "BuildingEscapeSettings.h"
+#include "BuildingEscapeTelemetry.h"
 #include "Components/AudioComponent.h"
 #include "Components/PrimitiveComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Containers/UnrealString.h"
+#include "DeferredInitSubsystem.h"
+#include "DrawDebugHelpers.h"
 #include "Engine/World.h"
 #include "GameFramework/Actor.h"
 #include "GameFramework/PlayerController.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Materials/MaterialExpressionDynamicParameter.h"
+#include "PressurePlateComponent.h"
+#include "RotationCommitSubsystem.h"
+#include "RotationStepComponent.h"
+#include "SoundCacheSubsystem.h"
+#include "TowerSaveSubsystem.h"
 
 #define OUT
 
@@ -20,6 +33,9 @@ UOpenDoor::UOpenDoor()
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
 	PrimaryComponentTick.bCanEverTick = true;
+
+	// Move the door before physics so the collision pose is current for this frame's simulation.
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
 }
 
 
@@ -28,25 +44,300 @@ void UOpenDoor::BeginPlay()
 {
 	Super::BeginPlay();
 
-	ActorThatOpens = GetWorld()->GetFirstPlayerController()->GetPawn();
+	ActorThatOpens = ABuildingEscapeGameModeBase::GetTowerPlayer(this);
+
+	// Read rotatable actor rotations only after the player has rotated them this frame.
+	PlayerInteraction = ActorThatOpens ? ActorThatOpens->FindComponentByClass<UInteractionComponent>() : nullptr;
+	if (PlayerInteraction)
+	{
+		AddTickPrerequisiteComponent(PlayerInteraction);
+	}
 	DoorRotation = GetOwner()->GetActorRotation();
 	InitialYaw = DoorRotation.Yaw;
 	OpenAngle += InitialYaw;
 	CurrentYaw = InitialYaw;
 
-	if (bUseRotatableActors) {CheckForRotatableActorMat();}
+	if (PressurePlateSensor)
+	{
+		SetPressurePlateComponent(PressurePlateSensor->FindComponentByClass<UPressurePlateComponent>());
+	}
+
+	RestoreSavedDoorState();
+
+	if (URotationCommitSubsystem* RotationCommit = URotationCommitSubsystem::Get(this))
+	{
+		RotationCommit->AddWriter(this);
+	}
+
+	ApplyTuning();
+	TuningChangedHandle = FBuildingEscapeTuning::OnChanged().AddUObject(this, &UOpenDoor::ApplyTuning);
+	GovernorLevelChangedHandle = BuildingEscapeFrameGovernor::OnLevelChanged().AddUObject(this, &UOpenDoor::ApplyTuning);
+
+	// Creating material instances and finding step components is spread over the next frames, nearest door first.
+	UDeferredInitSubsystem::EnqueueOrRun(this, FSimpleDelegate::CreateUObject(this, &UOpenDoor::InitializeDeferred), GetOwner()->GetActorLocation());
+}
+
+void UOpenDoor::InitializeDeferred()
+{
+	if (bUseRotatableActors)
+	{
+		CheckForRotatableActorMat();
+		BuildRotationStepMasks();
+	}
 	FillMatInstDynamicArray();
 
 	if (bUsePressurePlate) {CheckForPressurePlate();}
 	FindAudioComponent();
+	RegisterSounds();
+
+	ReadyTime = GetWorld()->GetTimeSeconds();
+	bIsReady = true;
+}
+
+void UOpenDoor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Remember a solved puzzle when the door's floor streams out, or is torn down by the floor generator, so it is
+	// still solved when the floor comes back.
+	UTowerSaveSubsystem* TowerSave = UTowerSaveSubsystem::Get(this);
+	const bool bIsFloorGoing = EndPlayReason == EEndPlayReason::RemovedFromWorld || EndPlayReason == EEndPlayReason::Destroyed;
+	if (TowerSave && bIsFloorGoing && bIsReady)
+	{
+		TowerSave->RecordDoorPuzzleSolved(this, IsPuzzleSolved());
+	}
+
+	FBuildingEscapeTuning::OnChanged().Remove(TuningChangedHandle);
+	BuildingEscapeFrameGovernor::OnLevelChanged().Remove(GovernorLevelChangedHandle);
+	if (URotationCommitSubsystem* RotationCommit = URotationCommitSubsystem::Get(this))
+	{
+		RotationCommit->RemoveWriter(this);
+	}
+	if (PressurePlateComponent)
+	{
+		PressurePlateComponent->OnWeightChanged.RemoveAll(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UOpenDoor::ApplyTuning()
+{
+	float NewTickInterval = FBuildingEscapeTuning::Get().DoorTickInterval;
+
+	// Under load, doors away from the player tick no more often than the frame governor allows.
+	bIsPlayerDistant = IsPlayerDistant();
+	if (bIsPlayerDistant)
+	{
+		NewTickInterval = FMath::Max(NewTickInterval, BuildingEscapeFrameGovernor::GetDistantTickInterval());
+	}
+
+	if (GetComponentTickInterval() != NewTickInterval)
+	{
+		SetComponentTickInterval(NewTickInterval);
+	}
+}
+
+bool UOpenDoor::IsPlayerDistant() const
+{
+	const float NearDistance = FBuildingEscapeTuning::Get().GovernorNearDistance;
+	return ActorThatOpens && FVector::DistSquared(ActorThatOpens->GetActorLocation(), GetOwner()->GetActorLocation()) > FMath::Square(NearDistance);
+}
+
+void UOpenDoor::SetSaveKey(FName NewSaveKey)
+{
+	if (SaveKey == NewSaveKey) {return;}
+	SaveKey = NewSaveKey;
+
+	// BeginPlay restored whatever was saved under the old key.
+	if (HasBegunPlay())
+	{
+		RestoreSavedDoorState();
+	}
+}
+
+void UOpenDoor::RestoreSavedDoorState()
+{
+	FDoorSaveState DoorState;
+	UTowerSaveSubsystem* TowerSave = UTowerSaveSubsystem::Get(this);
+	if (!TowerSave) {return;}
+	if (!TowerSave->FindDoorState(this, DoorState))
+	{
+		// Nothing saved for this door, so it starts closed.
+		DoorState.bIsOpen = false;
+		DoorState.Yaw = InitialYaw;
+		DoorState.bIsPuzzleSolved = false;
+	}
+
+	// Put the door straight into its saved pose without replaying the open animation or sound.
+	bIsDoorOpen = DoorState.bIsOpen;
+	bCanPlayOpenDoorSound = !bIsDoorOpen;
+	bCanPlayCloseDoorSound = bIsDoorOpen;
+	CurrentYaw = DoorState.Yaw;
+	DoorRotation.Yaw = CurrentYaw;
+	GetOwner()->SetActorRotation(DoorRotation);
+
+	// Rotatable actors restore their own steps; plates come back empty and need the saved result.
+	bIsPuzzleSolvedFromSave = DoorState.bIsPuzzleSolved && !bUseRotatableActors;
+	bHasReportedSolve = DoorState.bIsPuzzleSolved;
+}
+
+void UOpenDoor::SetDoorIsOpen(bool bNewIsOpen)
+{
+	if (bIsDoorOpen == bNewIsOpen) {return;}
+	bIsDoorOpen = bNewIsOpen;
+
+	// Record the pose the door is heading to, and checkpoint whenever a door opens.
+	UTowerSaveSubsystem* TowerSave = UTowerSaveSubsystem::Get(this);
+	if (!TowerSave) {return;}
+	TowerSave->RecordDoorState(this, bIsDoorOpen, bIsDoorOpen ? OpenAngle : InitialYaw);
+	if (bIsDoorOpen)
+	{
+		TowerSave->SaveCheckpoint();
+	}
+}
+
+void UOpenDoor::SetPressurePlate(ATriggerVolume* NewPressurePlate)
+{
+	PressurePlate = NewPressurePlate;
+	bUsePressurePlate = PressurePlate || PressurePlateComponent;
+}
+
+void UOpenDoor::SetPressurePlateComponent(UPressurePlateComponent* NewPressurePlateComponent)
+{
+	if (PressurePlateComponent)
+	{
+		PressurePlateComponent->OnWeightChanged.RemoveAll(this);
+	}
+
+	PressurePlateComponent = NewPressurePlateComponent;
+	bUsePressurePlate = PressurePlate || PressurePlateComponent;
+	bIsPressurePlatePressed = false;
+	PressurePlateMass = 0.f;
+
+	if (PressurePlateComponent)
+	{
+		PressurePlateComponent->OnWeightChanged.AddUObject(this, &UOpenDoor::OnPressurePlateWeightChanged);
+		OnPressurePlateWeightChanged(PressurePlateComponent, PressurePlateComponent->GetTotalMass());
+	}
+}
+
+void UOpenDoor::OnPressurePlateWeightChanged(UPressurePlateComponent* Plate, float NewTotalMass)
+{
+	bIsPressurePlatePressed = Plate->IsPressed();
+	PressurePlateMass = NewTotalMass;
+}
+
+void UOpenDoor::SetRotatableActors(const TArray<AActor*>& NewRotatableActors, const TArray<float>& NewRotatableActorsRotations)
+{
+	// Unbind from any previous actors before rebuilding the packed step masks.
+	for (URotationStepComponent* StepComponent : RotationStepComponents)
+	{
+		if (StepComponent)
+		{
+			StepComponent->OnRotationStepChanged.RemoveAll(this);
+		}
+	}
+
+	RotatableActors = NewRotatableActors;
+	RotatableActorsRotations = NewRotatableActorsRotations;
+	bUseRotatableActors = RotatableActors.Num() > 0;
+	bRotatableActorsHaveCorrectRotation = false;
+
+	// Not initialized yet, the deferred init will pick up the new actors.
+	if (!bIsReady) {return;}
+
+	if (bUseRotatableActors)
+	{
+		CheckForRotatableActorMat();
+		BuildRotationStepMasks();
+	}
+	FillMatInstDynamicArray();
 }
 
 void UOpenDoor::CheckForRotatableActorMat() const
 {
 	if (!RotatableActorMat)
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s is missing a Rotatable Actor Material!"), *GetOwner()->GetName());
+		UE_LOG(LogBuildingEscape, Error, TEXT("%s is missing a Rotatable Actor Material!"), *GetOwner()->GetName());
+	}
+}
+
+void UOpenDoor::BuildRotationStepMasks()
+{
+	CurrentStepMask = 0;
+	TargetStepMask = 0;
+	RotationStepComponents.Init(nullptr, RotatableActors.Num());
+
+	// Find (or add) the step component of each rotatable actor and size the packed fields for the largest step count.
+	int32 MaxNumSteps = 1;
+	for (int32 i = 0; i < RotatableActors.Num(); i++)
+	{
+		RotationStepComponents[i] = URotationStepComponent::FindOrAddTo(RotatableActors[i]);
+		if (RotationStepComponents[i])
+		{
+			MaxNumSteps = FMath::Max(MaxNumSteps, RotationStepComponents[i]->GetNumSteps());
+		}
+	}
+	StepBitsPerActor = FMath::Max(1, (int32)FMath::CeilLogTwo(MaxNumSteps));
+
+	if (RotatableActors.Num() * StepBitsPerActor > 64)
+	{
+		UE_LOG(LogBuildingEscape, Error, TEXT("%s has too many Rotatable Actors to pack their rotations!"), *GetOwner()->GetName());
+		StepBitsPerActor = 0;
+		return;
+	}
+
+	for (int32 i = 0; i < RotationStepComponents.Num(); i++)
+	{
+		// Actors missing a step component or a target rotation can never be correct.
+		if (!RotationStepComponents[i] || !RotatableActorsRotations.IsValidIndex(i))
+		{
+			UE_LOG(LogBuildingEscape, Error, TEXT("%s has a Rotatable Actor without a target rotation at index %d!"), *GetOwner()->GetName(), i);
+			StepBitsPerActor = 0;
+			return;
+		}
 	}
+
+	for (int32 i = 0; i < RotationStepComponents.Num(); i++)
+	{
+		URotationStepComponent* StepComponent = RotationStepComponents[i];
+		const uint64 Shift = i * StepBitsPerActor;
+		const int32 TargetStep = URotationStepComponent::QuantizeYaw(RotatableActorsRotations[i], StepComponent->GetStepDegrees());
+		TargetStepMask |= (uint64)TargetStep << Shift;
+		CurrentStepMask |= (uint64)StepComponent->GetYawStep() << Shift;
+
+		StepComponent->OnRotationStepChanged.AddUObject(this, &UOpenDoor::OnRotationStepChanged);
+	}
+}
+
+void UOpenDoor::OnRotationStepChanged(URotationStepComponent* StepComponent, int32 NewYawStep)
+{
+	const int32 IndexOfArray = RotationStepComponents.Find(StepComponent);
+	if (IndexOfArray == INDEX_NONE || StepBitsPerActor == 0) {return;}
+
+	const uint64 Shift = IndexOfArray * StepBitsPerActor;
+	const uint64 FieldMask = ((1ull << StepBitsPerActor) - 1) << Shift;
+	CurrentStepMask = (CurrentStepMask & ~FieldMask) | (((uint64)NewYawStep << Shift) & FieldMask);
+}
+
+bool UOpenDoor::IsRotatableActorAtTargetStep(int32 IndexOfArray) const
+{
+	if (StepBitsPerActor == 0) {return false;}
+
+	const uint64 FieldMask = ((1ull << StepBitsPerActor) - 1) << (IndexOfArray * StepBitsPerActor);
+	return ((CurrentStepMask ^ TargetStepMask) & FieldMask) == 0;
+}
+
+AActor* UOpenDoor::GetPressurePlateActor() const
+{
+	return PressurePlateComponent ? PressurePlateComponent->GetOwner() : PressurePlate;
+}
+
+bool UOpenDoor::IsPuzzleSolved() const
+{
+	if (bIsPuzzleSolvedFromSave) {return true;}
+	if (bUseRotatableActors) {return bRotatableActorsHaveCorrectRotation;}
+	if (PressurePlateComponent) {return bIsPressurePlatePressed;}
+	return PressurePlate && TotalMassOfActors() >= MassToOpenDoor;
 }
 
 void UOpenDoor::FillMatInstDynamicArray()
@@ -72,15 +363,31 @@ void UOpenDoor::FindAudioComponent()
 
 	if (!AudioComponent)
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s is missing an audio component!"), *GetOwner()->GetName());
+		UE_LOG(LogBuildingEscape, Error, TEXT("%s is missing an audio component!"), *GetOwner()->GetName());
+	}
+}
+
+void UOpenDoor::RegisterSounds() const
+{
+	USoundCacheSubsystem* SoundCache = USoundCacheSubsystem::Get(this);
+	if (!SoundCache) {return;}
+
+	// Decode the door and grinding sounds now, as part of the deferred init, rather than on the first interaction.
+	SoundCache->RegisterAudioComponent(AudioComponent, ESoundCacheGroup::Door);
+	for (AActor* RotatableActor : RotatableActors)
+	{
+		if (RotatableActor)
+		{
+			SoundCache->RegisterAudioComponent(RotatableActor->FindComponentByClass<UAudioComponent>(), ESoundCacheGroup::Rotation);
+		}
 	}
 }
 
 void UOpenDoor::CheckForPressurePlate() const
 {
-	if(!PressurePlate)
+	if(!PressurePlate && !PressurePlateComponent)
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s has an OpenDoor component attached, but no Pressure Plate set."), *GetOwner()->GetName());
+		UE_LOG(LogBuildingEscape, Error, TEXT("%s has an OpenDoor component attached, but no Pressure Plate set."), *GetOwner()->GetName());
 	}
 }
 
@@ -89,14 +396,39 @@ void UOpenDoor::TickComponent(float DeltaTime, ELevelTick TickType, FActorCompon
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	// Tuning and governor level changes re-apply through their delegates. Under load the interval also depends on
+	// which side of the near distance the player is, so only that is checked here.
+	if (BuildingEscapeFrameGovernor::GetLevel() > 0 && IsPlayerDistant() != bIsPlayerDistant)
+	{
+		ApplyTuning();
+	}
+
+	if (!bIsReady) {return;}
+
+	ensureMsgf(!PlayerInteraction || !PlayerInteraction->TicksEveryFrame() || PlayerInteraction->HasTickedThisFrame(),
+		TEXT("%s ticked before the player's InteractionComponent."), *GetOwner()->GetName());
+
 	if (bUseRotatableActors)
 	{
 		CheckActorsRotations(DeltaTime);
 	}
 
-	if (TotalMassOfActors() >= MassToOpenDoor || bRotatableActorsHaveCorrectRotation || CheckForOveralppingActorThatOpens())
+	const FBuildingEscapeTuning& Tuning = FBuildingEscapeTuning::Get();
+	const float TotalMass = TotalMassOfActors();
+	DrawDebugState(TotalMass);
+
+	// Pressure plate components have their own thresholds, with hysteresis.
+	const bool bIsPlatePressed = PressurePlateComponent ? bIsPressurePlatePressed : TotalMass >= MassToOpenDoor;
+
+	// Report the first time the puzzle is solved, timed from when the door became ready.
+	if (!bHasReportedSolve && (bUsePressurePlate ? bIsPlatePressed : bRotatableActorsHaveCorrectRotation))
+	{
+		bHasReportedSolve = true;
+		BuildingEscapeTelemetry::RecordPuzzleSolved(GetOwner(), GetWorld()->GetTimeSeconds() - ReadyTime);
+	}
+	if (bIsPlatePressed || bRotatableActorsHaveCorrectRotation || bIsPuzzleSolvedFromSave || CheckForOveralppingActorThatOpens())
 	{
-		if (GetWorld()->GetTimeSeconds() - DoorLastClosed >= DoorOpenDelay)
+		if (GetWorld()->GetTimeSeconds() - DoorLastClosed >= DoorOpenDelay * Tuning.DoorDelayScale)
 		{
 			OpenDoor(DeltaTime);
 			DoorLastOpened = GetWorld()->GetTimeSeconds();
@@ -104,7 +436,7 @@ void UOpenDoor::TickComponent(float DeltaTime, ELevelTick TickType, FActorCompon
 	}
 	else if (!bRotatableActorsHaveCorrectRotation)
 	{
-		if (GetWorld()->GetTimeSeconds() - DoorLastOpened >= DoorCloseDelay)
+		if (GetWorld()->GetTimeSeconds() - DoorLastOpened >= DoorCloseDelay * Tuning.DoorDelayScale)
 		{
 			CloseDoor(DeltaTime);
 			DoorLastClosed = GetWorld()->GetTimeSeconds();
@@ -112,12 +444,45 @@ void UOpenDoor::TickComponent(float DeltaTime, ELevelTick TickType, FActorCompon
 	}
 }
 
+void UOpenDoor::DrawDebugState(float TotalMass) const
+{
+#if BUILDINGESCAPE_DEBUG_DRAW
+	if (PressurePlateComponent && BuildingEscapeDebug::IsDrawEnabled(BuildingEscapeDebug::PressurePlates))
+	{
+		const FVector PlateOrigin = PressurePlateComponent->GetComponentLocation();
+		const FColor PlateColor = bIsPressurePlatePressed ? FColor::Green : FColor::Yellow;
+		DrawDebugBox(GetWorld(), PlateOrigin, PressurePlateComponent->GetScaledBoxExtent(), PressurePlateComponent->GetComponentQuat(), PlateColor);
+		DrawDebugString(GetWorld(), PlateOrigin, FString::Printf(TEXT("%.1f kg"), TotalMass), nullptr, PlateColor, 0.f);
+	}
+	else if (PressurePlate && BuildingEscapeDebug::IsDrawEnabled(BuildingEscapeDebug::PressurePlates))
+	{
+		FVector PlateOrigin;
+		FVector PlateExtent;
+		PressurePlate->GetActorBounds(false, PlateOrigin, PlateExtent);
+		const FColor PlateColor = TotalMass >= MassToOpenDoor ? FColor::Green : FColor::Yellow;
+		DrawDebugBox(GetWorld(), PlateOrigin, PlateExtent, PlateColor);
+		DrawDebugString(GetWorld(), PlateOrigin, FString::Printf(TEXT("%.1f / %.1f kg"), TotalMass, MassToOpenDoor), nullptr, PlateColor, 0.f);
+	}
+
+	if (BuildingEscapeDebug::IsDrawEnabled(BuildingEscapeDebug::Doors))
+	{
+		const FString DoorState = FString::Printf(TEXT("%s yaw %.1f%s"), bIsDoorOpen ? TEXT("Open") : TEXT("Closed"), CurrentYaw,
+			bUseRotatableActors ? (bRotatableActorsHaveCorrectRotation ? TEXT(" solved") : TEXT(" unsolved")) : TEXT(""));
+		DrawDebugString(GetWorld(), GetOwner()->GetActorLocation(), DoorState, nullptr, bIsDoorOpen ? FColor::Green : FColor::Red, 0.f);
+	}
+#endif
+}
+
 void UOpenDoor::OpenDoor(float DeltaTime)
 {
-	DoorRotation.Yaw = FMath::Lerp(CurrentYaw, OpenAngle, DoorOpenSpeed * DeltaTime);
+	if (!FMath::IsNearlyEqual(CurrentYaw, OpenAngle, 0.1f)) {BuildingEscapeTelemetry::CountActiveDoor();}
+
+	DoorRotation.Yaw = FMath::Lerp(CurrentYaw, OpenAngle, DoorOpenSpeed * FBuildingEscapeTuning::Get().DoorOpenSpeedScale * DeltaTime);
 	CurrentYaw = DoorRotation.Yaw;
 
-	GetOwner()->SetActorRotation(DoorRotation);
+	// Doors are kinematic, so move them without teleporting to push anything in the way.
+	URotationCommitSubsystem::CommitRotation(GetOwner(), DoorRotation, ETeleportType::None);
+	SetDoorIsOpen(true);
 
 	// Play door sound
 	bCanPlayCloseDoorSound = true;
@@ -131,10 +496,13 @@ void UOpenDoor::OpenDoor(float DeltaTime)
 
 void UOpenDoor::CloseDoor(float DeltaTime)
 {
-	DoorRotation.Yaw = FMath::Lerp(CurrentYaw, InitialYaw, DoorCloseSpeed * DeltaTime);
+	if (!FMath::IsNearlyEqual(CurrentYaw, InitialYaw, 0.1f)) {BuildingEscapeTelemetry::CountActiveDoor();}
+
+	DoorRotation.Yaw = FMath::Lerp(CurrentYaw, InitialYaw, DoorCloseSpeed * FBuildingEscapeTuning::Get().DoorCloseSpeedScale * DeltaTime);
 	CurrentYaw = DoorRotation.Yaw;
 
-	GetOwner()->SetActorRotation(DoorRotation);
+	URotationCommitSubsystem::CommitRotation(GetOwner(), DoorRotation, ETeleportType::None);
+	SetDoorIsOpen(false);
 
 	// Play door sound
 	bCanPlayOpenDoorSound = true;
@@ -148,6 +516,9 @@ void UOpenDoor::CloseDoor(float DeltaTime)
 
 float UOpenDoor::TotalMassOfActors() const
 {
+	// The pressure plate component keeps its own running total.
+	if (PressurePlateComponent) {return PressurePlateMass;}
+
 	float TotalMass = 0.f;
 
 	// Find all overlapping actors.
@@ -168,6 +539,7 @@ float UOpenDoor::TotalMassOfActors() const
 
 bool UOpenDoor::CheckForOveralppingActorThatOpens() const
 {
+	if (PressurePlateComponent) {return PressurePlateComponent->IsOverlappingActor(ActorThatOpens);}
 	if (!PressurePlate) {return false;}
 	return PressurePlate->IsOverlappingActor(ActorThatOpens);
 }
@@ -176,10 +548,11 @@ void UOpenDoor::CheckActorsRotations(float DeltaTime)
 {
 	if (RotatableActors.Num() == -1 || !RotatableActorsRotations.IsValidIndex(0) || MaterialInstDynamicArray.Num() == -1 || !RotatableActorMat) {return;}
 
-	// Loop through all RotatableActors, change their materials, and check if they have the "correct" rotation.
-	int32 NumCorrectRotations = 0;
+	// Loop through all RotatableActors and change their materials based on whether they have the "correct" rotation.
 	for (int32 i = 0; i < RotatableActors.Num(); i++)
 	{
+		if (!RotatableActors[i]) {continue;}
+
 		TArray<UStaticMeshComponent*> StaticComps;
 		RotatableActors[i]->GetComponents<UStaticMeshComponent>(OUT StaticComps);
 		for (UStaticMeshComponent* Component : StaticComps)
@@ -195,28 +568,21 @@ void UOpenDoor::CheckActorsRotations(float DeltaTime)
 			UpdateMatArray(i);
 		}
 		
-		if (FMath::Abs(RotatableActorsRotations[i]) == FMath::RoundToFloat(FMath::Abs(RotatableActors[i]->GetActorRotation().Yaw)))
+		if (IsRotatableActorAtTargetStep(i))
 		{
-			NumCorrectRotations += 1;
 			if (!bIsSecondDoor)
 			{
 				LerpMaterial(1.f, MaterialInstDynamicArray[i], NameOfBlendParamter, DeltaTime);
 			}
-
-			if (NumCorrectRotations >= RotatableActors.Num())
-			{
-				bRotatableActorsHaveCorrectRotation = true;
-			}
-			else
-			{
-				bRotatableActorsHaveCorrectRotation = false;
-			}
 		}
 		else if (!bIsSecondDoor)
 		{
 			LerpMaterial(0.f, MaterialInstDynamicArray[i], NameOfBlendParamter, DeltaTime);
 		}
 	}
+
+	// Every actor's step index matches its target step, so the puzzle is solved.
+	bRotatableActorsHaveCorrectRotation = StepBitsPerActor != 0 && CurrentStepMask == TargetStepMask;
 }
 
 void UOpenDoor::UpdateMatArray(int32 IndexOfArray)
@@ -238,8 +604,14 @@ void UOpenDoor::LerpMaterial(float NewMaterialMetalness, class UMaterialInstance
 	if (Material)
 	{
 		Material->GetScalarParameterValue(FMaterialParameterInfo(NameOfBlendParamter), CurrentMetalness);
+		if (CurrentMetalness == NewMaterialMetalness) {return;}
 
-		CurrentMetalness = FMath::Lerp(CurrentMetalness, NewMaterialMetalness, 0.8f * DeltaTime);
+		// Under load the blend jumps straight to its target; it also finishes once it is close enough to stop updating.
+		CurrentMetalness = FMath::Lerp(CurrentMetalness, NewMaterialMetalness, FBuildingEscapeTuning::Get().MaterialLerpRate * DeltaTime);
+		if (BuildingEscapeFrameGovernor::ShouldSnapMaterials() || FMath::IsNearlyEqual(CurrentMetalness, NewMaterialMetalness, KINDA_SMALL_NUMBER))
+		{
+			CurrentMetalness = NewMaterialMetalness;
+		}
 
 		Material->SetScalarParameterValue(NameOfBlendParamter, CurrentMetalness);
 	}
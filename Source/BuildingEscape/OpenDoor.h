@@ -21,35 +21,91 @@ public:
 
 	// Public Functions
 	void CheckActorsRotations(float DeltaTime);
+
+	// Wire this door up at runtime (e.g. from the floor generator) after it has begun play.
+	void SetPressurePlate(ATriggerVolume* NewPressurePlate);
+	void SetPressurePlateComponent(class UPressurePlateComponent* NewPressurePlateComponent);
+	void SetRotatableActors(const TArray<AActor*>& NewRotatableActors, const TArray<float>& NewRotatableActorsRotations);
+
+	// Key the saved door state by NewSaveKey (e.g. floor and door) instead of the actor's name, and restore the
+	// state saved under it. Generated doors get their names from spawn order, so their names cannot identify a door.
+	void SetSaveKey(FName NewSaveKey);
+	FName GetSaveKey() const {return SaveKey;}
+
+	// False until the deferred part of BeginPlay has run. The door does not tick until then.
+	bool IsReady() const {return bIsReady;}
+
+	// Puzzle state, read by the autoplayer.
+	bool IsDoorOpen() const {return bIsDoorOpen;}
+	bool UsesRotatableActors() const {return bUseRotatableActors;}
+	const TArray<AActor*>& GetRotatableActors() const {return RotatableActors;}
+	bool IsRotatableActorAtTargetStep(int32 IndexOfArray) const;
+	AActor* GetPressurePlateActor() const;
+
+	// True when the puzzle holds the door open by itself: the rotatable actors are solved or the plate is weighed
+	// down. Standing on the plate counts, so step off it before asking.
+	bool IsPuzzleSolved() const;
+
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
+	// Doors create material instances after their level's GC cluster is built, so they stay outside of it
+	// and the garbage collector keeps tracing their references.
+	virtual bool CanBeInCluster() const override {return false;}
+
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
+	void ApplyTuning();
+	bool IsPlayerDistant() const;
+	void InitializeDeferred();
 	bool CheckForOveralppingActorThatOpens() const;
 	float TotalMassOfActors() const;
 	void OpenDoor(float DeltaTime);
 	void CloseDoor(float DeltaTime);
 	void CheckForPressurePlate() const;
+	void OnPressurePlateWeightChanged(class UPressurePlateComponent* Plate, float NewTotalMass);
 	void FindAudioComponent();
+	void RegisterSounds() const;
 	void UpdateMatArray(int32 IndexOfArray);
 	void LerpMaterial(float NewMaterialMetalness, class UMaterialInstanceDynamic* Material, FName NameOfBlendParamter, float DeltaTime);
 	void CheckForRotatableActorMat() const;
 	void FillMatInstDynamicArray();
+	void BuildRotationStepMasks();
+	void OnRotationStepChanged(class URotationStepComponent* StepComponent, int32 NewYawStep);
+	void RestoreSavedDoorState();
+	void SetDoorIsOpen(bool bNewIsOpen);
+	void DrawDebugState(float TotalMass) const;
 
 	// Member Variables
 	bool bCanPlayCloseDoorSound = false;
 	bool bCanPlayOpenDoorSound = true;
+	bool bIsDoorOpen = false;
+	bool bIsReady = false;
 	bool bRotatableActorsHaveCorrectRotation = false;
+	bool bIsPressurePlatePressed = false;
+	bool bIsPuzzleSolvedFromSave = false;
+	bool bHasReportedSolve = false;
+	bool bIsPlayerDistant = false;
+	float PressurePlateMass = 0.f;
 	float CurrentYaw;
 	float DoorLastOpened = 0.f;
 	float DoorLastClosed = 0.f;
 	float InitialYaw;
 	float CurrentMetalness = 0.f;
+	float ReadyTime = 0.f;
 	FRotator DoorRotation;
+	FDelegateHandle TuningChangedHandle;
+	FDelegateHandle GovernorLevelChangedHandle;
+	FName SaveKey = NAME_None;
+
+	// Packed yaw step indices of RotatableActors, StepBitsPerActor bits per actor.
+	uint64 CurrentStepMask = 0;
+	uint64 TargetStepMask = 0;
+	int32 StepBitsPerActor = 0;
 
 	UPROPERTY(EditAnyWhere, Category = "Optional")
 	AActor* ActorThatOpens = nullptr;
@@ -57,6 +113,13 @@ private:
 	UPROPERTY(EditAnyWhere, meta = (EditCondition = "bUsePressurePlate"))
 	ATriggerVolume* PressurePlate = nullptr;
 
+	// Actor with a PressurePlateComponent. Used instead of Pressure Plate when set.
+	UPROPERTY(EditAnyWhere, meta = (EditCondition = "bUsePressurePlate"))
+	AActor* PressurePlateSensor = nullptr;
+
+	UPROPERTY()
+	class UPressurePlateComponent* PressurePlateComponent = nullptr;
+
 	UPROPERTY(EditAnyWhere)
 	bool bUsePressurePlate = true;
 
@@ -102,6 +165,13 @@ private:
 	UPROPERTY(EditAnyWhere, meta = (EditCondition = "bUseRotatableActors"), Category = "Rotatable Actors")
 	int32 MaterialIndex = 0;
 
+	UPROPERTY()
+	TArray<class URotationStepComponent*> RotationStepComponents;
+
+	// The player's interaction component, which rotates RotatableActors. Ticks before this door.
+	UPROPERTY()
+	UInteractionComponent* PlayerInteraction = nullptr;
+
 	UPROPERTY()
 	UStaticMeshComponent* ChangeMatMesh = nullptr;
 
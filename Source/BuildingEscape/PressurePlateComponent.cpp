@@ -0,0 +1,128 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "PressurePlateComponent.h"
+#include "BuildingEscape.h"
+#include "DefaultCharacter.h"
+#include "GameFramework/Actor.h"
+
+#define OUT
+
+// Sets default values for this component's properties
+UPressurePlateComponent::UPressurePlateComponent()
+{
+	// Everything is driven by overlap events, so this component never needs to tick.
+	PrimaryComponentTick.bCanEverTick = false;
+
+	InitBoxExtent(FVector(50.f, 50.f, 10.f));
+	SetCanEverAffectNavigation(false);
+
+	// Only physics bodies and pawns can press a plate, so skip overlap tests against everything else.
+	SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	SetCollisionObjectType(ECC_WorldStatic);
+	SetCollisionResponseToAllChannels(ECR_Ignore);
+	SetCollisionResponseToChannel(ECC_PhysicsBody, ECR_Overlap);
+	SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
+	SetGenerateOverlapEvents(true);
+}
+
+// Called when the game starts
+void UPressurePlateComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (DeactivationMass > ActivationMass)
+	{
+		UE_LOG(LogBuildingEscape, Warning, TEXT("%s has a Deactivation Mass above its Activation Mass, clamping it."), *GetOwner()->GetName());
+		DeactivationMass = ActivationMass;
+	}
+
+	OnComponentBeginOverlap.AddDynamic(this, &UPressurePlateComponent::OnBeginOverlap);
+	OnComponentEndOverlap.AddDynamic(this, &UPressurePlateComponent::OnEndOverlap);
+
+	// Pick up anything that was already resting on the plate when the level started.
+	TArray<UPrimitiveComponent*> OverlappingComponents;
+	GetOverlappingComponents(OUT OverlappingComponents);
+	for (UPrimitiveComponent* Component : OverlappingComponents)
+	{
+		AddOccupant(Component->GetOwner());
+	}
+	UpdateTotalMass();
+}
+
+void UPressurePlateComponent::OnBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	AddOccupant(OtherActor);
+	UpdateTotalMass();
+}
+
+void UPressurePlateComponent::OnEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	RemoveOccupant(OtherActor);
+	UpdateTotalMass();
+}
+
+void UPressurePlateComponent::AddOccupant(AActor* Actor)
+{
+	if (!Actor) {return;}
+
+	// Actors with several overlapping components (e.g. a capsule and a mesh) are only counted once.
+	FPressurePlateOccupant& Occupant = Occupants.FindOrAdd(Actor);
+	if (Occupant.NumOverlappingComponents++ == 0)
+	{
+		Occupant.Mass = FindOccupantMass(Actor);
+	}
+}
+
+void UPressurePlateComponent::RemoveOccupant(AActor* Actor)
+{
+	FPressurePlateOccupant* Occupant = Occupants.Find(Actor);
+	if (!Occupant) {return;}
+
+	if (--Occupant->NumOverlappingComponents <= 0)
+	{
+		Occupants.Remove(Actor);
+	}
+}
+
+float UPressurePlateComponent::FindOccupantMass(const AActor* Actor) const
+{
+	// The player's capsule does not simulate physics, so use the mass set on the character.
+	if (const ADefaultCharacter* Character = Cast<ADefaultCharacter>(Actor))
+	{
+		return Character->GetPlayerMass();
+	}
+
+	if (!Actor->IsRootComponentMovable()) {return 0.f;}
+	const UPrimitiveComponent* Root = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+	return Root ? Root->GetMass() : 0.f;
+}
+
+void UPressurePlateComponent::UpdateTotalMass()
+{
+	float NewTotalMass = 0.f;
+	for (auto It = Occupants.CreateIterator(); It; ++It)
+	{
+		// Destroyed actors end their overlaps, but drop any stale entry just in case.
+		if (!It->Key.IsValid())
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+		NewTotalMass += It->Value.Mass;
+	}
+
+	if (FMath::IsNearlyEqual(NewTotalMass, TotalMass)) {return;}
+	TotalMass = NewTotalMass;
+
+	if (!bIsPressed && TotalMass >= ActivationMass)
+	{
+		bIsPressed = true;
+	}
+	else if (bIsPressed && TotalMass < DeactivationMass)
+	{
+		bIsPressed = false;
+	}
+
+	OnWeightChanged.Broadcast(this, TotalMass);
+}
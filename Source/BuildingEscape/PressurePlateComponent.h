@@ -0,0 +1,66 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/BoxComponent.h"
+#include "PressurePlateComponent.generated.h"
+
+class UPressurePlateComponent;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnPressurePlateWeightChanged, UPressurePlateComponent*, float);
+
+struct FPressurePlateOccupant
+{
+	float Mass = 0.f;
+	int32 NumOverlappingComponents = 0;
+};
+
+// Box that only overlaps physics bodies and pawns and keeps a running total of the mass resting on it. Masses are
+// cached when an actor enters, so nothing is summed per frame. Any number of doors can listen to one plate.
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class BUILDINGESCAPE_API UPressurePlateComponent : public UBoxComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UPressurePlateComponent();
+
+	// Public Functions
+	float GetTotalMass() const {return TotalMass;}
+
+	// True once TotalMass reaches ActivationMass, false again once it drops below DeactivationMass.
+	bool IsPressed() const {return bIsPressed;}
+
+	// Broadcast whenever TotalMass changes, after IsPressed has been updated.
+	FOnPressurePlateWeightChanged OnWeightChanged;
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+private:
+	UFUNCTION()
+	void OnBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	void AddOccupant(AActor* Actor);
+	void RemoveOccupant(AActor* Actor);
+	float FindOccupantMass(const AActor* Actor) const;
+	void UpdateTotalMass();
+
+	// Member Variables
+	TMap<TWeakObjectPtr<AActor>, FPressurePlateOccupant> Occupants;
+	float TotalMass = 0.f;
+	bool bIsPressed = false;
+
+	UPROPERTY(EditAnyWhere, Category = "Pressure Plate", meta = (ClampMin = "0"))
+	float ActivationMass = 50.f;
+
+	// Must be at or below ActivationMass, so a load wobbling around the threshold does not flap the door.
+	UPROPERTY(EditAnyWhere, Category = "Pressure Plate", meta = (ClampMin = "0"))
+	float DeactivationMass = 40.f;
+};
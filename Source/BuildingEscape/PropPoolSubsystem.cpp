@@ -0,0 +1,170 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "PropPoolSubsystem.h"
+#include "BuildingEscape.h"
+#include "Components/MeshComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "RotationStepComponent.h"
+
+#define OUT
+
+// Actors are parked here while dormant so they are well away from anything that could still query them.
+static const FVector DormantLocation(0.f, 0.f, -100000.f);
+
+UPropPoolSubsystem* UPropPoolSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UPropPoolSubsystem>() : nullptr;
+}
+
+void UPropPoolSubsystem::Prewarm(TSubclassOf<AActor> ActorClass, int32 Count)
+{
+	if (!ActorClass) {return;}
+
+	FPropPool& Pool = Pools.FindOrAdd(ActorClass);
+	while (Pool.DormantActors.Num() < Count)
+	{
+		AActor* Actor = SpawnDormantActor(ActorClass);
+		if (!Actor) {return;}
+		Pool.DormantActors.Add(Actor);
+	}
+}
+
+AActor* UPropPoolSubsystem::Acquire(TSubclassOf<AActor> ActorClass, const FTransform& Transform)
+{
+	if (!ActorClass) {return nullptr;}
+
+	FPropPool& Pool = Pools.FindOrAdd(ActorClass);
+	AActor* Actor = nullptr;
+	while (!Actor && Pool.DormantActors.Num() > 0)
+	{
+		// Skip anything destroyed behind the pool's back.
+		Actor = Pool.DormantActors.Pop(false);
+		if (Actor && Actor->IsPendingKillPending()) {Actor = nullptr;}
+	}
+
+	if (!Actor)
+	{
+		UE_LOG(LogBuildingEscape, Verbose, TEXT("Prop pool for %s is empty, spawning a new actor."), *ActorClass->GetName());
+		Actor = SpawnDormantActor(ActorClass);
+		if (!Actor) {return nullptr;}
+	}
+
+	ResetToDefaults(Actor, Transform);
+	Pool.ActiveActors.Add(Actor);
+	return Actor;
+}
+
+void UPropPoolSubsystem::Release(AActor* Actor)
+{
+	if (!Actor || Actor->IsPendingKillPending()) {return;}
+
+	FPropPool* Pool = Pools.Find(Actor->GetClass());
+	if (!Pool || Pool->ActiveActors.RemoveSwap(Actor) == 0)
+	{
+		Actor->Destroy();
+		return;
+	}
+
+	OnReleased.Broadcast(Actor);
+	MakeDormant(Actor);
+	Pool->DormantActors.Add(Actor);
+}
+
+int32 UPropPoolSubsystem::GetNumDormant(TSubclassOf<AActor> ActorClass) const
+{
+	const FPropPool* Pool = Pools.Find(ActorClass);
+	return Pool ? Pool->DormantActors.Num() : 0;
+}
+
+AActor* UPropPoolSubsystem::SpawnDormantActor(UClass* ActorClass)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(ActorClass, FTransform(DormantLocation), SpawnParams);
+	if (Actor)
+	{
+		MakeDormant(Actor);
+	}
+	return Actor;
+}
+
+void UPropPoolSubsystem::MakeDormant(AActor* Actor)
+{
+	TArray<UPrimitiveComponent*> PrimitiveComponents;
+	Actor->GetComponents<UPrimitiveComponent>(OUT PrimitiveComponents);
+	for (UPrimitiveComponent* Component : PrimitiveComponents)
+	{
+		Component->SetSimulatePhysics(false);
+	}
+
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		Component->SetComponentTickEnabled(false);
+	}
+	Actor->SetActorLocation(DormantLocation, false, nullptr, ETeleportType::ResetPhysics);
+}
+
+void UPropPoolSubsystem::ResetToDefaults(AActor* Actor, const FTransform& Transform)
+{
+	Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Actor->SetActorEnableCollision(true);
+
+	TArray<UPrimitiveComponent*> PrimitiveComponents;
+	Actor->GetComponents<UPrimitiveComponent>(OUT PrimitiveComponents);
+	for (UPrimitiveComponent* Component : PrimitiveComponents)
+	{
+		// The archetype is the Blueprint's (or class default) version of this component.
+		const UPrimitiveComponent* Archetype = Cast<UPrimitiveComponent>(Component->GetArchetype());
+		if (!Archetype) {continue;}
+
+		// Grabbing changes the ECC_Pawn response, so restore every response rather than just that one.
+		Component->SetCollisionEnabled(Archetype->GetCollisionEnabled());
+		Component->SetCollisionResponseToChannels(Archetype->GetCollisionResponseToChannels());
+
+		// Rotatable actors get material instances from doors, so go back to the Blueprint's materials.
+		UMeshComponent* MeshComponent = Cast<UMeshComponent>(Component);
+		const UMeshComponent* MeshArchetype = Cast<UMeshComponent>(Archetype);
+		if (MeshComponent && MeshArchetype)
+		{
+			MeshComponent->EmptyOverrideMaterials();
+			for (int32 i = 0; i < MeshArchetype->OverrideMaterials.Num(); i++)
+			{
+				MeshComponent->SetMaterial(i, MeshArchetype->OverrideMaterials[i]);
+			}
+		}
+
+		Component->SetSimulatePhysics(Archetype->BodyInstance.bSimulatePhysics);
+		if (Component->IsSimulatingPhysics())
+		{
+			Component->SetPhysicsLinearVelocity(FVector::ZeroVector);
+			Component->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
+		}
+	}
+
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		if (Component->PrimaryComponentTick.bCanEverTick && Component->PrimaryComponentTick.bStartWithTickEnabled)
+		{
+			Component->SetComponentTickEnabled(true);
+		}
+	}
+	Actor->SetActorTickEnabled(Actor->PrimaryActorTick.bCanEverTick && Actor->PrimaryActorTick.bStartWithTickEnabled);
+	Actor->SetActorHiddenInGame(false);
+
+	// Rotatable actors restart at whatever yaw they were acquired with. That is not progress, so it is not saved, and
+	// the actor forgets the floor it was keyed to last time.
+	if (URotationStepComponent* StepComponent = Actor->FindComponentByClass<URotationStepComponent>())
+	{
+		StepComponent->ResetYawStepFromYaw(Transform.Rotator().Yaw);
+	}
+}
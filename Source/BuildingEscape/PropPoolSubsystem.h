@@ -0,0 +1,61 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "PropPoolSubsystem.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnPropReleased, AActor*);
+
+USTRUCT()
+struct FPropPool
+{
+	GENERATED_USTRUCT_BODY()
+
+
+	// Actors waiting to be acquired: hidden, without collision and not ticking.
+	UPROPERTY()
+	TArray<AActor*> DormantActors;
+
+	// Actors of this class currently handed out.
+	UPROPERTY()
+	TArray<AActor*> ActiveActors;
+};
+
+// Recycles physics props and rotatable actors instead of spawning and destroying them, so regenerating rooms does not
+// hitch on SpawnActor or leave garbage behind. Acquired actors are reset to their class defaults (physics, collision
+// responses and materials), released actors go dormant until they are acquired again.
+UCLASS()
+class BUILDINGESCAPE_API UPropPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Return the prop pool of WorldContextObject's world, if there is one.
+	static UPropPoolSubsystem* Get(const UObject* WorldContextObject);
+
+	// Spawn dormant actors until ActorClass has at least Count of them waiting.
+	void Prewarm(TSubclassOf<AActor> ActorClass, int32 Count);
+
+	// Return a reset actor of ActorClass at Transform, spawning one only if none are dormant.
+	AActor* Acquire(TSubclassOf<AActor> ActorClass, const FTransform& Transform);
+
+	// Put Actor back in its pool. Actors that did not come from the pool are destroyed instead.
+	void Release(AActor* Actor);
+
+	int32 GetNumDormant(TSubclassOf<AActor> ActorClass) const;
+
+	// Broadcast as an actor goes back to its pool, before it goes dormant, so anything holding on to it can let go.
+	FOnPropReleased OnReleased;
+
+private:
+	AActor* SpawnDormantActor(UClass* ActorClass);
+	static void MakeDormant(AActor* Actor);
+	static void ResetToDefaults(AActor* Actor, const FTransform& Transform);
+
+	// Member Variables
+	UPROPERTY()
+	TMap<UClass*, FPropPool> Pools;
+};
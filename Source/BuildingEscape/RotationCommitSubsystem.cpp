@@ -0,0 +1,129 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "RotationCommitSubsystem.h"
+#include "Components/ActorComponent.h"
+#include "Components/SceneComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Templates/TypeCompatibleBytes.h"
+
+// Rotations within this many degrees of the current one are not worth moving the actor for.
+static const float RotationCommitTolerance = 1.e-3f;
+
+// Moves kept open at once by Flush. A frame that moves more than this commits them in batches of this size.
+static const int32 MaxScopedMovesPerBatch = 32;
+
+void FRotationCommitTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target)
+	{
+		Target->Flush();
+	}
+}
+
+FString FRotationCommitTickFunction::DiagnosticMessage()
+{
+	return TEXT("URotationCommitSubsystem::Flush");
+}
+
+URotationCommitSubsystem* URotationCommitSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<URotationCommitSubsystem>() : nullptr;
+}
+
+void URotationCommitSubsystem::CommitRotation(AActor* Actor, const FRotator& Rotation, ETeleportType Teleport)
+{
+	if (!Actor) {return;}
+
+	if (URotationCommitSubsystem* RotationCommit = Get(Actor))
+	{
+		RotationCommit->QueueRotation(Actor, Rotation, Teleport);
+		return;
+	}
+	Actor->SetActorRotation(Rotation, Teleport);
+}
+
+void URotationCommitSubsystem::Deinitialize()
+{
+	if (CommitTickFunction.IsTickFunctionRegistered())
+	{
+		CommitTickFunction.UnRegisterTickFunction();
+	}
+	PendingRotations.Empty();
+
+	Super::Deinitialize();
+}
+
+void URotationCommitSubsystem::RegisterTickFunction()
+{
+	if (CommitTickFunction.IsTickFunctionRegistered() || !GetWorld()->PersistentLevel) {return;}
+
+	CommitTickFunction.Target = this;
+	CommitTickFunction.bCanEverTick = true;
+	CommitTickFunction.bStartWithTickEnabled = true;
+	CommitTickFunction.TickGroup = TG_PrePhysics;
+	CommitTickFunction.EndTickGroup = TG_PrePhysics;
+	CommitTickFunction.RegisterTickFunction(GetWorld()->PersistentLevel);
+}
+
+void URotationCommitSubsystem::AddWriter(UActorComponent* Writer)
+{
+	if (!Writer) {return;}
+
+	RegisterTickFunction();
+	CommitTickFunction.AddPrerequisite(Writer, Writer->PrimaryComponentTick);
+}
+
+void URotationCommitSubsystem::RemoveWriter(UActorComponent* Writer)
+{
+	if (!Writer) {return;}
+
+	CommitTickFunction.RemovePrerequisite(Writer, Writer->PrimaryComponentTick);
+}
+
+void URotationCommitSubsystem::QueueRotation(AActor* Actor, const FRotator& Rotation, ETeleportType Teleport)
+{
+	RegisterTickFunction();
+
+	// A later write in the same frame replaces the earlier one.
+	FPendingRotation& PendingRotation = PendingRotations.FindOrAdd(Actor);
+	PendingRotation.Rotation = Rotation;
+	PendingRotation.Teleport = Teleport;
+}
+
+void URotationCommitSubsystem::Flush()
+{
+	// Every move stays inside its scope until all of them are done, so no overlaps are evaluated against actors that
+	// have yet to move. Each touched root then updates its children and overlaps once. The scopes live in fixed
+	// storage on the stack rather than being allocated per move.
+	TTypeCompatibleBytes<FScopedMovementUpdate> ScopeStorage[MaxScopedMovesPerBatch];
+	int32 NumOpenScopes = 0;
+	auto CloseScopes = [&ScopeStorage, &NumOpenScopes]()
+	{
+		// Newest first, as nested scopes would be.
+		while (NumOpenScopes > 0)
+		{
+			ScopeStorage[--NumOpenScopes].GetTypedPtr()->~FScopedMovementUpdate();
+		}
+	};
+
+	for (const TPair<TWeakObjectPtr<AActor>, FPendingRotation>& Pair : PendingRotations)
+	{
+		AActor* Actor = Pair.Key.Get();
+		USceneComponent* Root = Actor ? Actor->GetRootComponent() : nullptr;
+		if (!Root) {continue;}
+
+		const FPendingRotation& PendingRotation = Pair.Value;
+		if (Actor->GetActorRotation().Equals(PendingRotation.Rotation, RotationCommitTolerance)) {continue;}
+
+		if (NumOpenScopes == MaxScopedMovesPerBatch) {CloseScopes();}
+		new (ScopeStorage[NumOpenScopes++].GetTypedPtr()) FScopedMovementUpdate(Root, EScopedUpdate::DeferredUpdates);
+		Actor->SetActorRotation(PendingRotation.Rotation, PendingRotation.Teleport);
+	}
+	PendingRotations.Reset();
+	CloseScopes();
+}
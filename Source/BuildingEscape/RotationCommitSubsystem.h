@@ -0,0 +1,73 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RotationCommitSubsystem.generated.h"
+
+class URotationCommitSubsystem;
+
+// Applies the frame's queued rotations once every writer has ticked.
+USTRUCT()
+struct FRotationCommitTickFunction : public FTickFunction
+{
+	GENERATED_USTRUCT_BODY()
+
+
+	URotationCommitSubsystem* Target = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FRotationCommitTickFunction> : public TStructOpsTypeTraitsBase2<FRotationCommitTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+struct FPendingRotation
+{
+	FRotator Rotation;
+	ETeleportType Teleport = ETeleportType::None;
+};
+
+// Collects the rotations doors and rotatable actors write during TG_PrePhysics and applies them in one pass after all
+// writers have ticked: only the last write per actor is applied, writes that would not change the rotation are
+// skipped, and the moves run inside scoped movement updates that stay open until every actor has moved, so children
+// and overlaps update once per actor, after the whole batch.
+UCLASS()
+class BUILDINGESCAPE_API URotationCommitSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Return the rotation commit subsystem of WorldContextObject's world, if there is one.
+	static URotationCommitSubsystem* Get(const UObject* WorldContextObject);
+
+	// Queue Actor's rotation for this frame's commit, or set it right away if there is no subsystem.
+	static void CommitRotation(AActor* Actor, const FRotator& Rotation, ETeleportType Teleport);
+
+	// Writers must tick before the commit. Call from BeginPlay and EndPlay of components that call CommitRotation.
+	void AddWriter(UActorComponent* Writer);
+	void RemoveWriter(UActorComponent* Writer);
+
+	void QueueRotation(AActor* Actor, const FRotator& Rotation, ETeleportType Teleport);
+
+	// Apply every queued rotation.
+	void Flush();
+
+private:
+	void RegisterTickFunction();
+
+	// Member Variables
+	TMap<TWeakObjectPtr<AActor>, FPendingRotation> PendingRotations;
+	FRotationCommitTickFunction CommitTickFunction;
+};
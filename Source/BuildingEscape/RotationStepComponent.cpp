@@ -0,0 +1,114 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "RotationStepComponent.h"
+#include "BuildingEscape.h"
+#include "GameFramework/Actor.h"
+#include "TowerSaveSubsystem.h"
+
+// Sets default values for this component's properties
+URotationStepComponent::URotationStepComponent()
+{
+	// The step index only changes when a rotation completes, so this component never needs to tick.
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+URotationStepComponent* URotationStepComponent::FindOrAddTo(AActor* Actor, float DefaultStepDegrees, FName SaveKey)
+{
+	if (!Actor) {return nullptr;}
+
+	URotationStepComponent* StepComponent = Actor->FindComponentByClass<URotationStepComponent>();
+	if (!StepComponent)
+	{
+		// Components added at runtime are not part of the actor's GC cluster, so prefer adding one in the Blueprint.
+		if (Actor->CanBeInCluster())
+		{
+			UE_LOG(LogBuildingEscape, Log, TEXT("%s has no RotationStep component, adding one at runtime."), *Actor->GetName());
+		}
+		StepComponent = NewObject<URotationStepComponent>(Actor, TEXT("RotationStep"));
+		StepComponent->StepDegrees = DefaultStepDegrees;
+		StepComponent->SaveKey = SaveKey;
+		StepComponent->RegisterComponent();
+	}
+	else if (SaveKey != NAME_None)
+	{
+		StepComponent->SetSaveKey(SaveKey);
+		StepComponent->RestoreSavedYawStep();
+	}
+	return StepComponent;
+}
+
+int32 URotationStepComponent::QuantizeYaw(float Yaw, float StepDegrees)
+{
+	if (StepDegrees <= KINDA_SMALL_NUMBER) {return 0;}
+
+	const int32 NumSteps = FMath::Max(1, FMath::RoundToInt(360.f / StepDegrees));
+	const int32 Step = FMath::RoundToInt(Yaw / StepDegrees) % NumSteps;
+
+	// Wrap negative yaws so -90 and 270 give the same step.
+	return Step < 0 ? Step + NumSteps : Step;
+}
+
+void URotationStepComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// Seed the step index from the actor's placed rotation.
+	if (GetOwner())
+	{
+		YawStep = QuantizeYaw(GetOwner()->GetActorRotation().Yaw, StepDegrees);
+	}
+}
+
+void URotationStepComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	RestoreSavedYawStep();
+}
+
+void URotationStepComponent::RestoreSavedYawStep()
+{
+	// Snap straight to the saved rotation instead of replaying the rotation animation.
+	int32 SavedYawStep = 0;
+	UTowerSaveSubsystem* TowerSave = UTowerSaveSubsystem::Get(this);
+	if (TowerSave && TowerSave->FindRotationStep(this, SavedYawStep))
+	{
+		FRotator ActorRotation = GetOwner()->GetActorRotation();
+		ActorRotation.Yaw = SavedYawStep * StepDegrees;
+		GetOwner()->SetActorRotation(ActorRotation);
+		SetYawStep(SavedYawStep);
+	}
+}
+
+void URotationStepComponent::SetYawStep(int32 NewYawStep)
+{
+	const int32 NumSteps = GetNumSteps();
+	NewYawStep = ((NewYawStep % NumSteps) + NumSteps) % NumSteps;
+	if (NewYawStep == YawStep) {return;}
+
+	YawStep = NewYawStep;
+	OnRotationStepChanged.Broadcast(this, YawStep);
+
+	if (UTowerSaveSubsystem* TowerSave = UTowerSaveSubsystem::Get(this))
+	{
+		TowerSave->RecordRotationStep(this, YawStep);
+	}
+}
+
+void URotationStepComponent::SetYawStepFromYaw(float Yaw)
+{
+	SetYawStep(QuantizeYaw(Yaw, StepDegrees));
+}
+
+void URotationStepComponent::ResetYawStepFromYaw(float Yaw)
+{
+	SaveKey = NAME_None;
+	YawStep = QuantizeYaw(Yaw, StepDegrees);
+}
+
+int32 URotationStepComponent::GetNumSteps() const
+{
+	if (StepDegrees <= KINDA_SMALL_NUMBER) {return 1;}
+	return FMath::Max(1, FMath::RoundToInt(360.f / StepDegrees));
+}
@@ -0,0 +1,69 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "RotationStepComponent.generated.h"
+
+class URotationStepComponent;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnRotationStepChanged, URotationStepComponent*, int32);
+
+// Holds the authoritative yaw of a rotatable actor as an integer step index (multiples of StepDegrees, mod 360).
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class BUILDINGESCAPE_API URotationStepComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	URotationStepComponent();
+
+	// Return the step component of Actor, creating and registering one if it does not have one yet. A SaveKey is set
+	// before a new component's BeginPlay restores the saved step, so the restore never goes by the actor's name; an
+	// existing component is re-keyed and snapped to the step saved under the new key.
+	static URotationStepComponent* FindOrAddTo(AActor* Actor, float DefaultStepDegrees = 90.f, FName SaveKey = NAME_None);
+
+	// Return Yaw quantized to a step index in the range [0, 360 / StepDegrees).
+	static int32 QuantizeYaw(float Yaw, float StepDegrees);
+
+	// Public Functions
+	void SetYawStep(int32 NewYawStep);
+	void SetYawStepFromYaw(float Yaw);
+	int32 GetNumSteps() const;
+
+	// Put the step back to Yaw's without recording it in the save, and forget the save key. Used when a pooled actor
+	// is reused, so its start yaw is not mistaken for progress.
+	void ResetYawStepFromYaw(float Yaw);
+
+	// Snap straight to the saved step, if there is one.
+	void RestoreSavedYawStep();
+
+	// Key the saved step by NewSaveKey (e.g. floor and slot) instead of the actor's name. Pooled actors keep their
+	// names as they move between floors, so their names cannot identify a puzzle piece.
+	void SetSaveKey(FName NewSaveKey) {SaveKey = NewSaveKey;}
+	FName GetSaveKey() const {return SaveKey;}
+
+	int32 GetYawStep() const {return YawStep;}
+	float GetStepDegrees() const {return StepDegrees;}
+
+	// Broadcast whenever YawStep changes.
+	FOnRotationStepChanged OnRotationStepChanged;
+
+protected:
+	// Called when the component is registered
+	virtual void OnRegister() override;
+
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+private:
+	UPROPERTY(EditAnyWhere, Category = "Rotatable Actors")
+	float StepDegrees = 90.f;
+
+	UPROPERTY(VisibleAnyWhere, Category = "Rotatable Actors")
+	int32 YawStep = 0;
+
+	FName SaveKey = NAME_None;
+};
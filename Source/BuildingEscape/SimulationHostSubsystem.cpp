@@ -0,0 +1,272 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "SimulationHostSubsystem.h"
+#include "AI/NavigationSystemBase.h"
+#include "AutoplaySubsystem.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeGameModeBase.h"
+#include "BuildingEscapeSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Level.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "TimerManager.h"
+#include "TowerSaveSubsystem.h"
+#include "UObject/UObjectGlobals.h"
+
+// Set while a session's game instance initializes, so it does not start hosting sessions of its own.
+static bool bIsCreatingSession = false;
+
+bool USimulationHostSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	int32 NumSessions = 0;
+	return !bIsCreatingSession && FParse::Value(FCommandLine::Get(), TEXT("HostSessions="), NumSessions) && NumSessions > 1;
+}
+
+void USimulationHostSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	int32 NumSessions = 0;
+	FParse::Value(FCommandLine::Get(), TEXT("HostSessions="), NumSessions);
+
+	// This game instance is session 0; it plays through the normal map flow but leaves exiting to the host.
+	Collection.InitializeDependency(UAutoplaySubsystem::StaticClass());
+	UAutoplaySubsystem* Autoplay = GetGameInstance()->GetSubsystem<UAutoplaySubsystem>();
+	if (!Autoplay || !Autoplay->IsActive())
+	{
+		UE_LOG(LogAutoplay, Error, TEXT("-HostSessions needs -Autoplay=N to drive its sessions, not hosting any."));
+		return;
+	}
+	Autoplay->SetExitWhenFinished(false);
+	Autoplay->OnFinished.AddUObject(this, &USimulationHostSubsystem::OnAutoplayFinished);
+
+	HostStartTime = FPlatformTime::Seconds();
+	for (int32 i = 1; i < NumSessions; i++)
+	{
+		CreateSession(i);
+	}
+	UE_LOG(LogAutoplay, Log, TEXT("Hosting %d tower sessions."), GetNumSessions());
+}
+
+void USimulationHostSubsystem::Deinitialize()
+{
+	for (FSimulationSession& Session : Sessions)
+	{
+		DestroySessionWorld(Session.GameInstance);
+		Session.World = nullptr;
+		if (Session.GameInstance)
+		{
+			Session.GameInstance->Shutdown();
+		}
+	}
+	Sessions.Empty();
+
+	Super::Deinitialize();
+}
+
+void USimulationHostSubsystem::CreateSession(int32 Index)
+{
+	FSimulationSession& Session = Sessions.AddDefaulted_GetRef();
+	Session.Index = Index;
+
+	// Each session gets its own game instance, and with it its own world context and game instance subsystems.
+	bIsCreatingSession = true;
+	Session.GameInstance = NewObject<UGameInstance>(GEngine, GetGameInstance()->GetClass());
+	Session.GameInstance->InitializeStandalone(*FString::Printf(TEXT("TowerSession%d"), Index));
+	bIsCreatingSession = false;
+
+	if (UTowerSaveSubsystem* TowerSave = Session.GameInstance->GetSubsystem<UTowerSaveSubsystem>())
+	{
+		TowerSave->SetSaveSlotName(FString::Printf(TEXT("TowerProgress_Session%d"), Index));
+	}
+	if (UAutoplaySubsystem* Autoplay = Session.GameInstance->GetSubsystem<UAutoplaySubsystem>())
+	{
+		Autoplay->SetHostedSession(true);
+		Autoplay->OnRunEnded.AddUObject(this, &USimulationHostSubsystem::OnSessionRunEnded);
+		Autoplay->OnFinished.AddUObject(this, &USimulationHostSubsystem::OnAutoplayFinished);
+	}
+
+	LoadSessionWorld(Session);
+}
+
+void USimulationHostSubsystem::LoadSessionWorld(FSimulationSession& Session)
+{
+	if (UTowerSaveSubsystem* TowerSave = Session.GameInstance->GetSubsystem<UTowerSaveSubsystem>())
+	{
+		TowerSave->ResetProgress();
+	}
+
+	// Load a fresh copy of the main level under a package name of its own, so sessions never share a world.
+	Session.LoadCount++;
+	const FString SourcePackageName = GetDefault<UBuildingEscapeSettings>()->MainLevel.GetLongPackageName();
+	const FString SessionPackageName = MakeSessionPackageName(SourcePackageName, Session.Index, Session.LoadCount);
+	// Background sessions never hold up the primary session's loads.
+	LoadPackageAsync(SessionPackageName, nullptr, *SourcePackageName,
+		FLoadPackageAsyncDelegate::CreateUObject(this, &USimulationHostSubsystem::OnSessionWorldLoaded, Session.Index),
+		PKG_None, INDEX_NONE, BuildingEscapeLoadPriority::HostedSession);
+}
+
+void USimulationHostSubsystem::OnSessionWorldLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result, int32 Index)
+{
+	FSimulationSession* Session = FindSession(Index);
+	if (!Session) {return;}
+
+	UWorld* World = LoadedPackage ? UWorld::FindWorldInPackage(LoadedPackage) : nullptr;
+	if (Result != EAsyncLoadingResult::Succeeded || !World)
+	{
+		UE_LOG(LogAutoplay, Error, TEXT("Session %d could not load %s, ending it."), Index, *PackageName.ToString());
+		if (UAutoplaySubsystem* Autoplay = Session->GameInstance->GetSubsystem<UAutoplaySubsystem>())
+		{
+			Autoplay->FinishRuns();
+		}
+		return;
+	}
+
+	StartSessionWorld(*Session, World);
+}
+
+void USimulationHostSubsystem::StartSessionWorld(FSimulationSession& Session, UWorld* World)
+{
+	InitSessionWorld(Session.GameInstance, World, Session.Index, Session.LoadCount);
+	Session.World = World;
+
+	// Doors and the win component look for the tower's player in BeginPlay, so the autoplayer's pawn comes first.
+	ABuildingEscapeGameModeBase* GameMode = World->GetAuthGameMode<ABuildingEscapeGameModeBase>();
+	UAutoplaySubsystem* Autoplay = Session.GameInstance->GetSubsystem<UAutoplaySubsystem>();
+	const bool bHasAutoplayer = GameMode && Autoplay && GameMode->StartAutoplayer(nullptr);
+
+	World->BeginPlay();
+
+	if (!bHasAutoplayer)
+	{
+		UE_LOG(LogAutoplay, Error, TEXT("Session %d has no autoplayer, ending it."), Session.Index);
+		if (Autoplay)
+		{
+			Autoplay->FinishRuns();
+		}
+		return;
+	}
+	Autoplay->StartRun(World);
+}
+
+FString USimulationHostSubsystem::MakeSessionPackageName(const FString& SourcePackageName, int32 SessionIndex, int32 LoadCount)
+{
+	return FString::Printf(TEXT("%s_Session%d_%d"), *SourcePackageName, SessionIndex, LoadCount);
+}
+
+void USimulationHostSubsystem::InitSessionWorld(UGameInstance* GameInstance, UWorld* World, int32 SessionIndex, int32 LoadCount)
+{
+	DestroySessionWorld(GameInstance);
+
+	FWorldContext* WorldContext = GameInstance->GetWorldContext();
+	World->WorldType = EWorldType::Game;
+	World->SetGameInstance(GameInstance);
+	World->AddToRoot();
+	WorldContext->SetCurrentWorld(World);
+
+	// Streaming levels would load into the source sublevel packages, which every session would then share. Load them
+	// under session names instead, the way PIE does; PackageNameToLoad keeps the package they are read from.
+	for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	{
+		if (!StreamingLevel) {continue;}
+		const FString SourcePackageName = StreamingLevel->GetWorldAssetPackageName();
+		if (StreamingLevel->PackageNameToLoad == NAME_None)
+		{
+			StreamingLevel->PackageNameToLoad = *SourcePackageName;
+		}
+		StreamingLevel->SetWorldAssetByPackageName(*MakeSessionPackageName(SourcePackageName, SessionIndex, LoadCount));
+	}
+
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld();
+	}
+
+	const FURL URL(*World->GetOutermost()->GetName());
+	World->SetGameMode(URL);
+	World->FlushLevelStreaming(EFlushLevelStreamingType::Visibility);
+	World->CreateAISystem();
+	World->InitializeActorsForPlay(URL);
+	// The autoplayer paths with MoveToActor, which needs the world's navigation system.
+	FNavigationSystem::AddNavigationSystemToWorld(*World, FNavigationSystemRunMode::GameMode);
+}
+
+void USimulationHostSubsystem::DestroySessionWorld(UGameInstance* GameInstance)
+{
+	FWorldContext* WorldContext = GameInstance ? GameInstance->GetWorldContext() : nullptr;
+	UWorld* World = WorldContext ? WorldContext->World() : nullptr;
+	if (!World) {return;}
+
+	World->BeginTearingDown();
+	for (ULevel* Level : World->GetLevels())
+	{
+		for (AActor* Actor : Level->Actors)
+		{
+			if (Actor)
+			{
+				Actor->RouteEndPlay(EEndPlayReason::LevelTransition);
+			}
+		}
+	}
+
+	WorldContext->SetCurrentWorld(nullptr);
+	World->RemoveFromRoot();
+	World->DestroyWorld(true);
+}
+
+void USimulationHostSubsystem::OnSessionRunEnded(UAutoplaySubsystem* Autoplay, bool bSucceeded)
+{
+	FSimulationSession* Session = FindSession(Autoplay);
+	if (!Session) {return;}
+
+	// The run ended inside the session world's tick, so replace the world on the next frame.
+	GetGameInstance()->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &USimulationHostSubsystem::RestartSession, Session->Index));
+}
+
+void USimulationHostSubsystem::RestartSession(int32 Index)
+{
+	FSimulationSession* Session = FindSession(Index);
+	UAutoplaySubsystem* Autoplay = Session ? Session->GameInstance->GetSubsystem<UAutoplaySubsystem>() : nullptr;
+	if (!Autoplay) {return;}
+
+	if (Autoplay->HasRunsLeft())
+	{
+		LoadSessionWorld(*Session);
+		return;
+	}
+	DestroySessionWorld(Session->GameInstance);
+	Session->World = nullptr;
+	Autoplay->FinishRuns();
+}
+
+void USimulationHostSubsystem::OnAutoplayFinished(UAutoplaySubsystem* Autoplay)
+{
+	if (FSimulationSession* Session = FindSession(Autoplay))
+	{
+		if (Session->bIsFinished) {return;}
+		Session->bIsFinished = true;
+	}
+
+	NumFinished++;
+	if (NumFinished < GetNumSessions()) {return;}
+
+	UE_LOG(LogAutoplay, Log, TEXT("All %d hosted sessions finished in %.2f s."), GetNumSessions(), FPlatformTime::Seconds() - HostStartTime);
+	FPlatformMisc::RequestExit(false);
+}
+
+FSimulationSession* USimulationHostSubsystem::FindSession(const UAutoplaySubsystem* Autoplay)
+{
+	return Sessions.FindByPredicate([Autoplay](const FSimulationSession& Session) {return Session.GameInstance == Autoplay->GetGameInstance();});
+}
+
+FSimulationSession* USimulationHostSubsystem::FindSession(int32 Index)
+{
+	return Sessions.FindByPredicate([Index](const FSimulationSession& Session) {return Session.Index == Index;});
+}
@@ -0,0 +1,85 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/Package.h"
+#include "SimulationHostSubsystem.generated.h"
+
+class UAutoplaySubsystem;
+
+USTRUCT()
+struct FSimulationSession
+{
+	GENERATED_USTRUCT_BODY()
+
+
+	// Owns the session's world context and its own game instance subsystems (save slot, autoplay, ...).
+	UPROPERTY()
+	UGameInstance* GameInstance;
+
+	UPROPERTY()
+	UWorld* World;
+
+	int32 Index;
+	int32 LoadCount;
+	bool bIsFinished;
+
+	// Default constructor.
+	FSimulationSession()
+	{
+		GameInstance = nullptr;
+		World = nullptr;
+		Index = INDEX_NONE;
+		LoadCount = 0;
+		bIsFinished = false;
+	}
+};
+
+// Runs several tower sessions in one process when started with -HostSessions=N -Autoplay=R (and usually -nullrhi):
+// the normal game world is session 0, and N-1 more worlds of the main level are loaded, each (sublevels included)
+// under its own package name with its own game instance and an autoplayer that plays it R times. The engine ticks
+// every world context on the game thread one after another, so sessions are time sliced, not threaded. The process
+// exits once every session has finished its runs.
+UCLASS()
+class BUILDINGESCAPE_API USimulationHostSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	int32 GetNumSessions() const {return Sessions.Num() + 1;}
+
+	// Return the package name a session loads its copy of the given map or sublevel under.
+	static FString MakeSessionPackageName(const FString& SourcePackageName, int32 SessionIndex, int32 LoadCount);
+
+	// Make World the current world of GameInstance and get it ready for BeginPlay, taking the same steps
+	// UEngine::LoadMap takes for a new game world minus the local player. The world's streaming sublevels are
+	// renamed to session package names first, so they load into packages of their own.
+	static void InitSessionWorld(UGameInstance* GameInstance, UWorld* World, int32 SessionIndex, int32 LoadCount);
+
+	// End play in GameInstance's current world and destroy it.
+	static void DestroySessionWorld(UGameInstance* GameInstance);
+
+private:
+	void CreateSession(int32 Index);
+	void LoadSessionWorld(FSimulationSession& Session);
+	void OnSessionWorldLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result, int32 Index);
+	void StartSessionWorld(FSimulationSession& Session, UWorld* World);
+	void OnSessionRunEnded(UAutoplaySubsystem* Autoplay, bool bSucceeded);
+	void RestartSession(int32 Index);
+	void OnAutoplayFinished(UAutoplaySubsystem* Autoplay);
+	FSimulationSession* FindSession(const UAutoplaySubsystem* Autoplay);
+	FSimulationSession* FindSession(int32 Index);
+
+	// Member Variables
+	int32 NumFinished = 0;
+	double HostStartTime = 0.0;
+
+	UPROPERTY()
+	TArray<FSimulationSession> Sessions;
+};
@@ -0,0 +1,115 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "SoundCacheSubsystem.h"
+#include "AudioDevice.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeSettings.h"
+#include "Components/AudioComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Sound/SoundConcurrency.h"
+#include "Sound/SoundCue.h"
+#include "Sound/SoundNodeWavePlayer.h"
+#include "Sound/SoundWave.h"
+
+void USoundCacheSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UBuildingEscapeSettings* Settings = GetDefault<UBuildingEscapeSettings>();
+	RotationConcurrency = CreateConcurrency(TEXT("RotationConcurrency"), Settings->MaxRotationSounds);
+	DoorConcurrency = CreateConcurrency(TEXT("DoorConcurrency"), Settings->MaxDoorSounds);
+}
+
+USoundCacheSubsystem* USoundCacheSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<USoundCacheSubsystem>() : nullptr;
+}
+
+USoundConcurrency* USoundCacheSubsystem::CreateConcurrency(const TCHAR* Name, int32 MaxCount)
+{
+	// Past the limit, the sound furthest from the listener gives way, then the oldest.
+	USoundConcurrency* Concurrency = NewObject<USoundConcurrency>(this, Name);
+	Concurrency->Concurrency.MaxCount = FMath::Max(1, MaxCount);
+	Concurrency->Concurrency.bLimitToOwner = false;
+	Concurrency->Concurrency.ResolutionRule = EMaxConcurrentResolutionRule::StopFarthestThenOldest;
+	return Concurrency;
+}
+
+void USoundCacheSubsystem::RegisterAudioComponent(UAudioComponent* AudioComponent, ESoundCacheGroup Group)
+{
+	if (!AudioComponent) {return;}
+
+	AudioComponent->ConcurrencySet.Add(Group == ESoundCacheGroup::Rotation ? RotationConcurrency : DoorConcurrency);
+	PrecacheSound(AudioComponent->Sound);
+}
+
+void USoundCacheSubsystem::PlayOrResume(UAudioComponent* AudioComponent)
+{
+	if (!AudioComponent) {return;}
+
+	if (AudioComponent->IsPlaying())
+	{
+		// Cancels a fade out in progress, without stopping the voice and decoding the sound again.
+		AudioComponent->AdjustVolume(0.1f, 1.f);
+		return;
+	}
+	AudioComponent->Play();
+}
+
+void USoundCacheSubsystem::PrecacheSound(USoundBase* Sound)
+{
+	if (!Sound || PrecachedSounds.Contains(Sound)) {return;}
+	PrecachedSounds.Add(Sound);
+
+	// Dedicated servers and -nosound runs have no audio device, so there is nothing to decode for.
+	FAudioDevice* AudioDevice = GetWorld()->GetAudioDevice();
+	if (!AudioDevice) {return;}
+
+	TArray<USoundWave*> SoundWaves;
+	if (USoundWave* SoundWave = Cast<USoundWave>(Sound))
+	{
+		SoundWaves.Add(SoundWave);
+	}
+	else if (USoundCue* SoundCue = Cast<USoundCue>(Sound))
+	{
+		TArray<USoundNodeWavePlayer*> WavePlayers;
+		SoundCue->RecursiveFindNode<USoundNodeWavePlayer>(SoundCue->FirstNode, WavePlayers);
+		for (USoundNodeWavePlayer* WavePlayer : WavePlayers)
+		{
+			if (WavePlayer->GetSoundWave())
+			{
+				SoundWaves.Add(WavePlayer->GetSoundWave());
+			}
+		}
+	}
+
+	const UBuildingEscapeSettings* Settings = GetDefault<UBuildingEscapeSettings>();
+	const int64 CacheBudgetBytes = (int64)Settings->DecodedSoundCacheKB * 1024;
+	for (USoundWave* SoundWave : SoundWaves)
+	{
+		// Loops and long sounds stream and decode in real time instead of sitting decoded in memory.
+		if (Sound->IsLooping() || SoundWave->bLooping || SoundWave->Duration > Settings->DecodedSoundMaxDuration)
+		{
+			if (!SoundWave->IsStreaming())
+			{
+				UE_LOG(LogBuildingEscape, Warning, TEXT("%s is a %.1f s loop or long sound but is not set to stream; turn on Streaming in the sound wave."),
+					*SoundWave->GetName(), SoundWave->Duration);
+			}
+			continue;
+		}
+
+		const int64 DecodedBytes = (int64)(SoundWave->Duration * SoundWave->SampleRate) * SoundWave->NumChannels * sizeof(int16);
+		if (DecodedCacheBytes + DecodedBytes > CacheBudgetBytes)
+		{
+			UE_LOG(LogBuildingEscape, Log, TEXT("Decoded sound cache is full, %s will decode when played."), *SoundWave->GetName());
+			continue;
+		}
+
+		DecodedCacheBytes += DecodedBytes;
+		AudioDevice->Precache(SoundWave, false, true, true);
+		UE_LOG(LogBuildingEscape, Verbose, TEXT("Precached %s decoded (%lld KB, %lld KB cached)."), *SoundWave->GetName(), DecodedBytes / 1024, DecodedCacheBytes / 1024);
+	}
+}
@@ -0,0 +1,58 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SoundCacheSubsystem.generated.h"
+
+class UAudioComponent;
+class USoundBase;
+class USoundConcurrency;
+
+// Which shared concurrency limit a sound plays under.
+enum class ESoundCacheGroup : uint8
+{
+	Rotation,
+	Door
+};
+
+// Manages how the tower's puzzle sounds are decoded and how many play at once. Short one-shot sounds (up to
+// DecodedSoundMaxDuration seconds) are decoded to PCM once, up to DecodedSoundCacheKB in total, so retriggering them
+// costs no decoding; loops and longer sounds are left to stream and decode in real time. Every registered audio
+// component plays under one concurrency limit per group, so spamming Interact on several pillars at once cannot start
+// more than MaxRotationSounds grinding sounds.
+UCLASS()
+class BUILDINGESCAPE_API USoundCacheSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// Return the sound cache of WorldContextObject's world, if there is one.
+	static USoundCacheSubsystem* Get(const UObject* WorldContextObject);
+
+	// Precache AudioComponent's sound and put the component under Group's concurrency limit. Safe to call repeatedly.
+	void RegisterAudioComponent(UAudioComponent* AudioComponent, ESoundCacheGroup Group);
+
+	// Play AudioComponent's sound, or bring it back to full volume if it is still playing or fading out, rather than
+	// restarting it.
+	static void PlayOrResume(UAudioComponent* AudioComponent);
+
+private:
+	void PrecacheSound(USoundBase* Sound);
+	USoundConcurrency* CreateConcurrency(const TCHAR* Name, int32 MaxCount);
+
+	// Member Variables
+	int64 DecodedCacheBytes = 0;
+
+	UPROPERTY()
+	TSet<USoundBase*> PrecachedSounds;
+
+	UPROPERTY()
+	USoundConcurrency* RotationConcurrency = nullptr;
+
+	UPROPERTY()
+	USoundConcurrency* DoorConcurrency = nullptr;
+};
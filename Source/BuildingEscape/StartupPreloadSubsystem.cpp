@@ -0,0 +1,76 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "StartupPreloadSubsystem.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeSettings.h"
+#include "BuildingEscapeStartupTiming.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "UObject/UObjectGlobals.h"
+
+void UStartupPreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UStartupPreloadSubsystem::OnPostLoadMap);
+}
+
+void UStartupPreloadSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	PreloadedWorld = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UStartupPreloadSubsystem::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	if (!LoadedWorld || LoadedWorld->GetGameInstance() != GetGameInstance()) {return;}
+
+	const UBuildingEscapeSettings* Settings = GetDefault<UBuildingEscapeSettings>();
+	const FString LoadedPackageName = LoadedWorld->GetOutermost()->GetName();
+	const FString MainLevelPackageName = Settings->MainLevel.GetLongPackageName();
+
+	if (LoadedPackageName == MainLevelPackageName)
+	{
+		// Only claim the preload helped if LoadMap actually reused the world it loaded. The world context keeps it
+		// alive from here on.
+		const bool bUsedPreload = PreloadedWorld && LoadedWorld == PreloadedWorld;
+		if (PreloadedWorld && !bUsedPreload)
+		{
+			// LoadMap loaded the main level a second time, so the preload only cost memory and load time.
+			UE_LOG(LogBuildingEscape, Warning, TEXT("LoadMap loaded %s again (package %p) instead of using the preloaded world (package %p)."),
+				*LoadedPackageName, LoadedWorld->GetOutermost(), PreloadedWorld->GetOutermost());
+		}
+		BuildingEscapeStartupTiming::Mark(bUsedPreload ? TEXT("Main level opened (preloaded)") : TEXT("Main level opened (not preloaded)"));
+		PreloadedWorld = nullptr;
+		return;
+	}
+
+	if (bIsPreloading || PreloadedWorld || MainLevelPackageName.IsEmpty()) {return;}
+	if (LoadedPackageName != Settings->LoadingScreenLevel.GetLongPackageName()) {return;}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UStartupPreloadSubsystem::StartPreload);
+	bIsPreloading = true;
+	PreloadStartTime = FPlatformTime::Seconds();
+	BuildingEscapeStartupTiming::Mark(FString::Printf(TEXT("Preload of %s started"), *MainLevelPackageName));
+	LoadPackageAsync(MainLevelPackageName, FLoadPackageAsyncDelegate::CreateUObject(this, &UStartupPreloadSubsystem::OnMainLevelLoaded), BuildingEscapeLoadPriority::MainLevel);
+}
+
+void UStartupPreloadSubsystem::OnMainLevelLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result)
+{
+	bIsPreloading = false;
+
+	// The package alone would not keep the world alive through LoadMap's garbage collection, so hold the world.
+	UWorld* LoadedWorld = (Result == EAsyncLoadingResult::Succeeded && LoadedPackage) ? UWorld::FindWorldInPackage(LoadedPackage) : nullptr;
+	if (!LoadedWorld)
+	{
+		UE_LOG(LogBuildingEscape, Warning, TEXT("Preloading %s failed, it will load when opened instead."), *PackageName.ToString());
+		return;
+	}
+
+	PreloadedWorld = LoadedWorld;
+	BuildingEscapeStartupTiming::Mark(FString::Printf(TEXT("Preload of %s finished in %.3f s"), *PackageName.ToString(), FPlatformTime::Seconds() - PreloadStartTime));
+}
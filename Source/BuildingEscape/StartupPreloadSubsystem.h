@@ -0,0 +1,40 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/Package.h"
+#include "StartupPreloadSubsystem.generated.h"
+
+class UWorld;
+
+// Starts loading the main level asynchronously as soon as the loading screen level is up, so it loads while the
+// player reads the EULA. The loaded world is referenced until the main level is opened, so the garbage collection in
+// LoadMap leaves it (and its levels and actors) alone and LoadMap picks it up instead of loading the map again. A
+// world loaded outside LoadMap stays Inactive, which is what lets it outlive the transition.
+UCLASS()
+class BUILDINGESCAPE_API UStartupPreloadSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// True once the main level has finished loading in the background.
+	UFUNCTION(BlueprintCallable)
+	bool IsMainLevelPreloaded() const {return PreloadedWorld != nullptr;}
+
+private:
+	void OnPostLoadMap(UWorld* LoadedWorld);
+	void OnMainLevelLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result);
+
+	// Member Variables
+	bool bIsPreloading = false;
+	double PreloadStartTime = 0.0;
+	FDelegateHandle PostLoadMapHandle;
+
+	UPROPERTY()
+	UWorld* PreloadedWorld = nullptr;
+};
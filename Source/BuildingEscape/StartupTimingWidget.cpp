@@ -0,0 +1,22 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "StartupTimingWidget.h"
+#include "BuildingEscapeStartupTiming.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+void UStartupTimingWidget::NativeOnInitialized()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UStartupTimingWidget::NativeOnInitialized);
+	Super::NativeOnInitialized();
+
+	BuildingEscapeStartupTiming::Mark(FString::Printf(TEXT("Widget %s initialized"), *GetClass()->GetName()));
+}
+
+void UStartupTimingWidget::NativeConstruct()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UStartupTimingWidget::NativeConstruct);
+	Super::NativeConstruct();
+
+	BuildingEscapeStartupTiming::Mark(FString::Printf(TEXT("Widget %s constructed"), *GetClass()->GetName()));
+}
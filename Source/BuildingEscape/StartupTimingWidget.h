@@ -0,0 +1,18 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "StartupTimingWidget.generated.h"
+
+// Base class for the startup widgets (LoadingScreenStartup, EULA) that records their construction in the startup timing log.
+UCLASS()
+class BUILDINGESCAPE_API UStartupTimingWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void NativeOnInitialized() override;
+	virtual void NativeConstruct() override;
+};
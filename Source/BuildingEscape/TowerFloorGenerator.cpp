@@ -0,0 +1,390 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "TowerFloorGenerator.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeGameModeBase.h"
+#include "BuildingEscapeTowerFloors.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "OpenDoor.h"
+#include "PressurePlateComponent.h"
+#include "PropPoolSubsystem.h"
+#include "RotationStepComponent.h"
+#include "UObject/ConstructorHelpers.h"
+
+// Sets default values
+ATowerFloorGenerator::ATowerFloorGenerator()
+{
+	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	PrimaryActorTick.bCanEverTick = true;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+	LoadAssets();
+}
+
+void ATowerFloorGenerator::LoadAssets()
+{
+	// Meshes
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> WallMeshObj(
+		TEXT("/Game/Meshes/StaticMeshes/BlankWall/BlankWall")
+	);
+	WallMesh = WallMeshObj.Object;
+
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> LadderMeshObj(
+		TEXT("/Game/Meshes/StaticMeshes/Ladder/Ladder6_5m")
+	);
+	LadderMesh = LadderMeshObj.Object;
+
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> FoliageMeshObj(
+		TEXT("/Game/Meshes/StaticMeshes/RosemaryBush/Bush")
+	);
+	FoliageMesh = FoliageMeshObj.Object;
+
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> FloorMeshObj(
+		TEXT("/Engine/BasicShapes/Cube")
+	);
+	FloorMesh = FloorMeshObj.Object;
+}
+
+// Called when the game starts or when spawned
+void ATowerFloorGenerator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!DoorClass)
+	{
+		UE_LOG(LogBuildingEscape, Error, TEXT("%s has no Door Class set, floors will have no doors!"), *GetName());
+	}
+
+	// Enough rotatable actors for every floor in the streaming window, so streaming floors in never spawns them.
+	UPropPoolSubsystem* PropPool = UPropPoolSubsystem::Get(this);
+	if (PropPool && RotatableActorClass)
+	{
+		PropPool->Prewarm(RotatableActorClass, RotatableActorsPerPuzzle * BuildingEscapeTowerFloors::GetMaxResidentFloors());
+	}
+
+	UpdateStreaming();
+}
+
+// Called every frame
+void ATowerFloorGenerator::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UpdateStreaming();
+
+	// Spend at most GenerationBudgetMs building floors, nearest floor first.
+	const double EndTime = FPlatformTime::Seconds() + GenerationBudgetMs / 1000.0;
+	while (BuildQueue.Num() > 0 && FPlatformTime::Seconds() < EndTime)
+	{
+		FGeneratedFloor* Floor = GeneratedFloors.Find(BuildQueue[0]);
+		if (!Floor)
+		{
+			BuildQueue.RemoveAt(0);
+			continue;
+		}
+
+		if (BuildFloorStep(*Floor, EndTime))
+		{
+			FinishFloor(*Floor);
+			BuildQueue.RemoveAt(0);
+		}
+	}
+}
+
+int32 ATowerFloorGenerator::GetFloorIndexAt(const FVector& WorldLocation) const
+{
+	return BuildingEscapeTowerFloors::GetFloorIndexAt(WorldLocation.Z, GetActorLocation().Z, NumberOfFloors);
+}
+
+FVector ATowerFloorGenerator::GetFloorOrigin(int32 FloorIndex) const
+{
+	const FVector Location = GetActorLocation();
+	return FVector(Location.X, Location.Y, BuildingEscapeTowerFloors::GetFloorBaseZ(FloorIndex, Location.Z));
+}
+
+void ATowerFloorGenerator::UpdateStreaming()
+{
+	APawn* PlayerPawn = ABuildingEscapeGameModeBase::GetTowerPlayer(this);
+	if (!PlayerPawn) {return;}
+
+	const int32 PlayerFloor = GetFloorIndexAt(PlayerPawn->GetActorLocation());
+	const int32 FirstFloor = FMath::Max(0, PlayerFloor - BuildingEscapeTowerFloors::GetMaxResidentFloors());
+	const int32 LastFloor = FMath::Min(NumberOfFloors - 1, PlayerFloor + BuildingEscapeTowerFloors::GetMaxResidentFloors());
+
+	// Stream out floors that fell outside the window.
+	TArray<int32> FloorsToRemove;
+	for (const TPair<int32, FGeneratedFloor>& Pair : GeneratedFloors)
+	{
+		if (!BuildingEscapeTowerFloors::ShouldBeResident(Pair.Key, PlayerFloor, true))
+		{
+			FloorsToRemove.Add(Pair.Key);
+		}
+	}
+	for (int32 FloorIndex : FloorsToRemove)
+	{
+		RemoveFloor(FloorIndex);
+	}
+
+	for (int32 FloorIndex = FirstFloor; FloorIndex <= LastFloor; FloorIndex++)
+	{
+		if (BuildingEscapeTowerFloors::ShouldBeResident(FloorIndex, PlayerFloor, false))
+		{
+			RequestFloor(FloorIndex);
+		}
+	}
+
+	// Build the floor the player is on first, then the ones closest to it.
+	BuildQueue.Sort([PlayerFloor](int32 A, int32 B)
+	{
+		return FMath::Abs(A - PlayerFloor) < FMath::Abs(B - PlayerFloor);
+	});
+}
+
+void ATowerFloorGenerator::RequestFloor(int32 FloorIndex)
+{
+	if (GeneratedFloors.Contains(FloorIndex)) {return;}
+
+	FGeneratedFloor& Floor = GeneratedFloors.Add(FloorIndex);
+	Floor.FloorIndex = FloorIndex;
+	LayoutFloor(Floor);
+	BuildQueue.Add(FloorIndex);
+}
+
+void ATowerFloorGenerator::RemoveFloor(int32 FloorIndex)
+{
+	FGeneratedFloor* Floor = GeneratedFloors.Find(FloorIndex);
+	if (!Floor) {return;}
+
+	for (UHierarchicalInstancedStaticMeshComponent* InstancedMesh : {Floor->Walls, Floor->Ladders, Floor->Foliage, Floor->Floors})
+	{
+		if (InstancedMesh)
+		{
+			InstancedMesh->DestroyComponent();
+		}
+	}
+
+	// Rotatable actors go back to the pool, everything else is destroyed.
+	UPropPoolSubsystem* PropPool = UPropPoolSubsystem::Get(this);
+	for (AActor* SpawnedActor : Floor->SpawnedActors)
+	{
+		if (!SpawnedActor) {continue;}
+
+		if (PropPool && Floor->RotatableActors.Contains(SpawnedActor))
+		{
+			PropPool->Release(SpawnedActor);
+		}
+		else
+		{
+			SpawnedActor->Destroy();
+		}
+	}
+
+	BuildQueue.Remove(FloorIndex);
+	GeneratedFloors.Remove(FloorIndex);
+}
+
+void ATowerFloorGenerator::LayoutFloor(FGeneratedFloor& Floor) const
+{
+	// Each floor gets its own stream so a floor looks the same no matter when or in what order it is generated.
+	FRandomStream Stream(HashCombine(GetTypeHash(Seed), GetTypeHash(Floor.FloorIndex)));
+	const FVector Origin = GetFloorOrigin(Floor.FloorIndex);
+	const float InnerHalfSize = FloorHalfSize - 150.f;
+
+	if (FloorMesh)
+	{
+		Floor.PendingFloors.Add(FTransform(FRotator::ZeroRotator, Origin, FloorMeshScale));
+	}
+
+	// Walls around all four sides, leaving one segment open for the door.
+	const int32 SegmentsPerSide = FMath::Max(1, FMath::CeilToInt(2.f * FloorHalfSize / WallSegmentLength));
+	const int32 DoorSide = Stream.RandRange(0, 3);
+	const int32 DoorSegment = Stream.RandRange(0, SegmentsPerSide - 1);
+	for (int32 Side = 0; Side < 4; Side++)
+	{
+		const FRotator SideRotation(0.f, Side * 90.f, 0.f);
+		const FVector SideCenter = Origin + SideRotation.RotateVector(FVector(FloorHalfSize, 0.f, 0.f));
+		const FVector Along = SideRotation.RotateVector(FVector(0.f, 1.f, 0.f));
+
+		for (int32 Segment = 0; Segment < SegmentsPerSide; Segment++)
+		{
+			const float Offset = -FloorHalfSize + (Segment + 0.5f) * WallSegmentLength;
+			const FTransform SegmentTransform(SideRotation, SideCenter + Along * Offset);
+
+			if (Side == DoorSide && Segment == DoorSegment && DoorClass)
+			{
+				FPendingActorSpawn DoorSpawn;
+				DoorSpawn.ActorClass = DoorClass;
+				DoorSpawn.Transform = SegmentTransform;
+				Floor.PendingSpawns.Add(DoorSpawn);
+				continue;
+			}
+			Floor.PendingWalls.Add(SegmentTransform);
+		}
+	}
+
+	// A ladder up to the next floor in one of the corners.
+	if (Floor.FloorIndex < NumberOfFloors - 1)
+	{
+		const FRotator CornerRotation(0.f, Stream.RandRange(0, 3) * 90.f, 0.f);
+		Floor.PendingLadders.Add(FTransform(CornerRotation, Origin + CornerRotation.RotateVector(FVector(InnerHalfSize, InnerHalfSize, 0.f))));
+	}
+
+	const int32 NumFoliage = Stream.RandRange(MinFoliagePerFloor, FMath::Max(MinFoliagePerFloor, MaxFoliagePerFloor));
+	for (int32 i = 0; i < NumFoliage; i++)
+	{
+		const FVector Location = Origin + FVector(Stream.FRandRange(-InnerHalfSize, InnerHalfSize), Stream.FRandRange(-InnerHalfSize, InnerHalfSize), 0.f);
+		Floor.PendingFoliage.Add(FTransform(FRotator(0.f, Stream.FRandRange(0.f, 360.f), 0.f), Location, FVector(Stream.FRandRange(0.8f, 1.2f))));
+	}
+
+	// The door is opened either by a rotation puzzle or by a pressure plate.
+	if (RotatableActorClass && Stream.FRand() < RotationPuzzleChance)
+	{
+		for (int32 i = 0; i < RotatableActorsPerPuzzle; i++)
+		{
+			FPendingActorSpawn RotatableSpawn;
+			RotatableSpawn.ActorClass = RotatableActorClass;
+			RotatableSpawn.bIsRotatableActor = true;
+			RotatableSpawn.TargetYaw = Stream.RandRange(0, 3) * 90.f;
+
+			// Start one to three steps away from the solution so the puzzle is never already solved.
+			const float StartYaw = RotatableSpawn.TargetYaw + Stream.RandRange(1, 3) * 90.f;
+			const float Spacing = 2.f * InnerHalfSize / RotatableActorsPerPuzzle;
+			const FVector Location = Origin + FVector(0.f, -InnerHalfSize + (i + 0.5f) * Spacing, 0.f);
+			RotatableSpawn.Transform = FTransform(FRotator(0.f, StartYaw, 0.f), Location);
+			Floor.PendingSpawns.Add(RotatableSpawn);
+		}
+	}
+	else if (PressurePlateClass)
+	{
+		FPendingActorSpawn PlateSpawn;
+		PlateSpawn.ActorClass = PressurePlateClass;
+		PlateSpawn.Transform = FTransform(Origin + FVector(Stream.FRandRange(-InnerHalfSize, InnerHalfSize), Stream.FRandRange(-InnerHalfSize, InnerHalfSize), 0.f));
+		Floor.PendingSpawns.Add(PlateSpawn);
+	}
+}
+
+UHierarchicalInstancedStaticMeshComponent* ATowerFloorGenerator::CreateInstancedMesh(UStaticMesh* Mesh, int32 FloorIndex, const TCHAR* Name)
+{
+	UHierarchicalInstancedStaticMeshComponent* InstancedMesh = NewObject<UHierarchicalInstancedStaticMeshComponent>(this,
+		MakeUniqueObjectName(this, UHierarchicalInstancedStaticMeshComponent::StaticClass(), *FString::Printf(TEXT("%s_%d"), Name, FloorIndex)));
+	InstancedMesh->SetStaticMesh(Mesh);
+	InstancedMesh->SetMobility(EComponentMobility::Static);
+
+	// The cluster tree is built once when the floor is finished rather than after every added instance.
+	InstancedMesh->bAutoRebuildTreeOnInstanceChanges = false;
+	InstancedMesh->SetupAttachment(RootComponent);
+	InstancedMesh->RegisterComponent();
+	return InstancedMesh;
+}
+
+bool ATowerFloorGenerator::BuildFloorStep(FGeneratedFloor& Floor, double EndTime)
+{
+	// Add instances in small batches, checking the clock between batches.
+	const int32 BatchSize = 8;
+	auto DrainInstances = [&](TArray<FTransform>& Pending, UHierarchicalInstancedStaticMeshComponent*& InstancedMesh, UStaticMesh* Mesh, const TCHAR* Name)
+	{
+		while (Pending.Num() > 0 && FPlatformTime::Seconds() < EndTime)
+		{
+			if (!InstancedMesh)
+			{
+				InstancedMesh = CreateInstancedMesh(Mesh, Floor.FloorIndex, Name);
+			}
+
+			const int32 NumToAdd = FMath::Min(BatchSize, Pending.Num());
+			for (int32 i = Pending.Num() - NumToAdd; i < Pending.Num(); i++)
+			{
+				InstancedMesh->AddInstanceWorldSpace(Pending[i]);
+			}
+			Pending.RemoveAt(Pending.Num() - NumToAdd, NumToAdd, false);
+		}
+		return Pending.Num() == 0;
+	};
+
+	if (!DrainInstances(Floor.PendingFloors, Floor.Floors, FloorMesh, TEXT("Floor"))) {return false;}
+	if (!DrainInstances(Floor.PendingWalls, Floor.Walls, WallMesh, TEXT("Walls"))) {return false;}
+	if (!DrainInstances(Floor.PendingLadders, Floor.Ladders, LadderMesh, TEXT("Ladders"))) {return false;}
+	if (!DrainInstances(Floor.PendingFoliage, Floor.Foliage, FoliageMesh, TEXT("Foliage"))) {return false;}
+
+	// Spawning is the most expensive step, so spawn (or take from the pool) one actor at a time.
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.Owner = this;
+	UPropPoolSubsystem* PropPool = UPropPoolSubsystem::Get(this);
+	while (Floor.PendingSpawns.Num() > 0 && FPlatformTime::Seconds() < EndTime)
+	{
+		const FPendingActorSpawn Spawn = Floor.PendingSpawns.Pop(false);
+		AActor* SpawnedActor = (Spawn.bIsRotatableActor && PropPool)
+			? PropPool->Acquire(Spawn.ActorClass, Spawn.Transform)
+			: GetWorld()->SpawnActor<AActor>(Spawn.ActorClass, Spawn.Transform, SpawnParams);
+		if (!SpawnedActor) {continue;}
+
+		Floor.SpawnedActors.Add(SpawnedActor);
+		if (Spawn.bIsRotatableActor)
+		{
+			// Saved rotations follow the puzzle slot, not whichever pooled actor happens to fill it.
+			URotationStepComponent::FindOrAddTo(SpawnedActor, 90.f, *FString::Printf(TEXT("Floor%d.Slot%d"), Floor.FloorIndex, Floor.RotatableActors.Num()));
+
+			Floor.RotatableActors.Add(SpawnedActor);
+			Floor.RotatableActorsRotations.Add(Spawn.TargetYaw);
+		}
+		else if (Spawn.ActorClass == DoorClass)
+		{
+			// A floor has one door. Like rotatables, it is saved by its place in the tower, not its spawn order name.
+			if (UOpenDoor* OpenDoor = SpawnedActor->FindComponentByClass<UOpenDoor>())
+			{
+				OpenDoor->SetSaveKey(*FString::Printf(TEXT("Floor%d.Door0"), Floor.FloorIndex));
+			}
+			Floor.Door = SpawnedActor;
+		}
+		else if (Spawn.ActorClass == PressurePlateClass)
+		{
+			Floor.PressurePlate = SpawnedActor;
+		}
+	}
+	return Floor.PendingSpawns.Num() == 0;
+}
+
+void ATowerFloorGenerator::FinishFloor(FGeneratedFloor& Floor)
+{
+	for (UHierarchicalInstancedStaticMeshComponent* InstancedMesh : {Floor.Walls, Floor.Ladders, Floor.Foliage, Floor.Floors})
+	{
+		if (InstancedMesh)
+		{
+			InstancedMesh->BuildTreeIfOutdated(true, false);
+		}
+	}
+
+	// Wire the floor's door to its puzzle now that every actor exists.
+	UOpenDoor* OpenDoor = Floor.Door ? Floor.Door->FindComponentByClass<UOpenDoor>() : nullptr;
+	if (OpenDoor)
+	{
+		if (Floor.RotatableActors.Num() > 0)
+		{
+			OpenDoor->SetPressurePlate(nullptr);
+			OpenDoor->SetRotatableActors(Floor.RotatableActors, Floor.RotatableActorsRotations);
+		}
+		else if (UPressurePlateComponent* PlateComponent = Floor.PressurePlate ? Floor.PressurePlate->FindComponentByClass<UPressurePlateComponent>() : nullptr)
+		{
+			OpenDoor->SetPressurePlate(nullptr);
+			OpenDoor->SetPressurePlateComponent(PlateComponent);
+		}
+		else if (Floor.PressurePlate)
+		{
+			// A trigger volume spawned from a class has no brush, so it could never be stood on.
+			UE_LOG(LogBuildingEscape, Error, TEXT("%s spawned pressure plate %s without a PressurePlate component!"), *GetName(), *Floor.PressurePlate->GetName());
+		}
+	}
+	else if (Floor.Door)
+	{
+		UE_LOG(LogBuildingEscape, Error, TEXT("%s spawned door %s without an OpenDoor component!"), *GetName(), *Floor.Door->GetName());
+	}
+
+	Floor.bIsComplete = true;
+}
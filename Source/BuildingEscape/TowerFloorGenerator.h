@@ -0,0 +1,197 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Templates/SubclassOf.h"
+#include "TowerFloorGenerator.generated.h"
+
+class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMesh;
+
+USTRUCT()
+struct FPendingActorSpawn
+{
+	GENERATED_USTRUCT_BODY()
+
+
+	UPROPERTY()
+	TSubclassOf<AActor> ActorClass;
+
+	UPROPERTY()
+	FTransform Transform;
+
+	// Rotatable actors are wired to the floor's door as a rotation puzzle.
+	UPROPERTY()
+	bool bIsRotatableActor;
+
+	UPROPERTY()
+	float TargetYaw;
+
+	// Default constructor.
+	FPendingActorSpawn()
+	{
+		ActorClass = nullptr;
+		bIsRotatableActor = false;
+		TargetYaw = 0.f;
+	}
+};
+
+USTRUCT()
+struct FGeneratedFloor
+{
+	GENERATED_USTRUCT_BODY()
+
+
+	UPROPERTY()
+	int32 FloorIndex;
+
+	UPROPERTY()
+	UHierarchicalInstancedStaticMeshComponent* Walls;
+
+	UPROPERTY()
+	UHierarchicalInstancedStaticMeshComponent* Ladders;
+
+	UPROPERTY()
+	UHierarchicalInstancedStaticMeshComponent* Foliage;
+
+	UPROPERTY()
+	UHierarchicalInstancedStaticMeshComponent* Floors;
+
+	UPROPERTY()
+	TArray<AActor*> SpawnedActors;
+
+	UPROPERTY()
+	AActor* Door;
+
+	UPROPERTY()
+	AActor* PressurePlate;
+
+	UPROPERTY()
+	TArray<AActor*> RotatableActors;
+
+	UPROPERTY()
+	TArray<float> RotatableActorsRotations;
+
+	// Layout still waiting to be instanced. Drained a little every frame.
+	TArray<FTransform> PendingWalls;
+	TArray<FTransform> PendingLadders;
+	TArray<FTransform> PendingFoliage;
+	TArray<FTransform> PendingFloors;
+	TArray<FPendingActorSpawn> PendingSpawns;
+	bool bIsComplete;
+
+	// Default constructor.
+	FGeneratedFloor()
+	{
+		FloorIndex = INDEX_NONE;
+		Walls = nullptr;
+		Ladders = nullptr;
+		Foliage = nullptr;
+		Floors = nullptr;
+		Door = nullptr;
+		PressurePlate = nullptr;
+		bIsComplete = false;
+	}
+};
+
+// Lays out tower floors from a seed using hierarchical instanced static meshes, and streams them in and out around
+// the player by the window in BuildingEscapeTowerFloors. Generation is time sliced: each frame only spends GenerationBudgetMs on adding instances and spawning actors.
+UCLASS()
+class BUILDINGESCAPE_API ATowerFloorGenerator : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	ATowerFloorGenerator();
+
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+	// Return the floor the given world location is on, clamped to the tower.
+	int32 GetFloorIndexAt(const FVector& WorldLocation) const;
+
+	// Floors are created and destroyed at runtime, so keep the generator out of its level's GC cluster.
+	virtual bool CanBeInCluster() const override {return false;}
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	void LoadAssets();
+
+private:
+	void UpdateStreaming();
+	void RequestFloor(int32 FloorIndex);
+	void RemoveFloor(int32 FloorIndex);
+	void LayoutFloor(FGeneratedFloor& Floor) const;
+	bool BuildFloorStep(FGeneratedFloor& Floor, double EndTime);
+	void FinishFloor(FGeneratedFloor& Floor);
+	UHierarchicalInstancedStaticMeshComponent* CreateInstancedMesh(UStaticMesh* Mesh, int32 FloorIndex, const TCHAR* Name);
+	FVector GetFloorOrigin(int32 FloorIndex) const;
+
+	// Member Variables
+	TArray<int32> BuildQueue;
+
+	UPROPERTY()
+	TMap<int32, FGeneratedFloor> GeneratedFloors;
+
+	UPROPERTY(EditAnyWhere, Category = "Generation")
+	int32 Seed = 1337;
+
+	UPROPERTY(EditAnyWhere, Category = "Generation", meta = (ClampMin = "1"))
+	int32 NumberOfFloors = 300;
+
+	// Half the width of a (square) floor.
+	UPROPERTY(EditAnyWhere, Category = "Generation")
+	float FloorHalfSize = 800.f;
+
+	UPROPERTY(EditAnyWhere, Category = "Generation")
+	float WallSegmentLength = 400.f;
+
+	UPROPERTY(EditAnyWhere, Category = "Generation")
+	int32 MinFoliagePerFloor = 2;
+
+	UPROPERTY(EditAnyWhere, Category = "Generation")
+	int32 MaxFoliagePerFloor = 6;
+
+	// Chance that a floor's door is opened by a rotation puzzle instead of a pressure plate.
+	UPROPERTY(EditAnyWhere, Category = "Generation", meta = (ClampMin = "0", ClampMax = "1"))
+	float RotationPuzzleChance = 0.5f;
+
+	UPROPERTY(EditAnyWhere, Category = "Generation", meta = (ClampMin = "1"))
+	int32 RotatableActorsPerPuzzle = 4;
+
+	// Milliseconds per frame spent building floors.
+	UPROPERTY(EditAnyWhere, Category = "Streaming")
+	float GenerationBudgetMs = 2.f;
+
+	UPROPERTY(EditAnyWhere, Category = "Meshes")
+	UStaticMesh* WallMesh = nullptr;
+
+	UPROPERTY(EditAnyWhere, Category = "Meshes")
+	UStaticMesh* LadderMesh = nullptr;
+
+	UPROPERTY(EditAnyWhere, Category = "Meshes")
+	UStaticMesh* FoliageMesh = nullptr;
+
+	UPROPERTY(EditAnyWhere, Category = "Meshes")
+	UStaticMesh* FloorMesh = nullptr;
+
+	// Scale applied to FloorMesh so one instance covers a whole floor.
+	UPROPERTY(EditAnyWhere, Category = "Meshes")
+	FVector FloorMeshScale = FVector(16.f, 16.f, 0.2f);
+
+	// Actor with an OpenDoor component.
+	UPROPERTY(EditAnyWhere, Category = "Puzzles")
+	TSubclassOf<AActor> DoorClass;
+
+	// Actor with a PressurePlate component.
+	UPROPERTY(EditAnyWhere, Category = "Puzzles")
+	TSubclassOf<AActor> PressurePlateClass;
+
+	UPROPERTY(EditAnyWhere, Category = "Puzzles")
+	TSubclassOf<AActor> RotatableActorClass;
+};
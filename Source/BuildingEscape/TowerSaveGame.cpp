@@ -0,0 +1,4 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "TowerSaveGame.h"
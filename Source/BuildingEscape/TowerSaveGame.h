@@ -0,0 +1,58 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SaveGame.h"
+#include "TowerSaveGame.generated.h"
+
+USTRUCT()
+struct FDoorSaveState
+{
+	GENERATED_USTRUCT_BODY()
+
+
+	UPROPERTY()
+	bool bIsOpen;
+
+	UPROPERTY()
+	float Yaw;
+
+	// The door's puzzle was solved when its floor streamed out. Plates lose their props on reload, so this keeps
+	// the door open.
+	UPROPERTY()
+	bool bIsPuzzleSolved;
+
+	// Default constructor.
+	FDoorSaveState()
+	{
+		bIsOpen = false;
+		Yaw = 0.f;
+		bIsPuzzleSolved = false;
+	}
+};
+
+// Compact snapshot of tower progress. Actors are keyed by "<Map>.<ActorName>" so keys stay stable across sessions;
+// generated doors and rotatable actors, whose names depend on spawn order, are keyed by "<Map>.Floor<N>.Door<M>" and
+// "<Map>.Floor<N>.Slot<M>" instead.
+UCLASS()
+class BUILDINGESCAPE_API UTowerSaveGame : public USaveGame
+{
+	GENERATED_BODY()
+
+public:
+	// Bump whenever the layout or the keys of this class change; older saves are discarded.
+	static const int32 CurrentSaveVersion = 5;
+
+	UPROPERTY()
+	int32 SaveVersion = CurrentSaveVersion;
+
+	UPROPERTY()
+	TMap<FName, FDoorSaveState> DoorStates;
+
+	UPROPERTY()
+	TMap<FName, int32> RotationSteps;
+
+	UPROPERTY()
+	bool bHasWon = false;
+};
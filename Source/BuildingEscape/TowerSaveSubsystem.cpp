@@ -0,0 +1,169 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "TowerSaveSubsystem.h"
+#include "BuildingEscape.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/PackageName.h"
+#include "OpenDoor.h"
+#include "RotationStepComponent.h"
+
+void UTowerSaveSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// The save is a handful of small maps, so loading it synchronously before the first level begins play is cheap.
+	if (UGameplayStatics::DoesSaveGameExist(SaveSlotName, SaveUserIndex))
+	{
+		SaveGame = Cast<UTowerSaveGame>(UGameplayStatics::LoadGameFromSlot(SaveSlotName, SaveUserIndex));
+	}
+
+	if (SaveGame && SaveGame->SaveVersion != UTowerSaveGame::CurrentSaveVersion)
+	{
+		UE_LOG(LogBuildingEscape, Warning, TEXT("Discarding tower save with version %d."), SaveGame->SaveVersion);
+		SaveGame = nullptr;
+	}
+
+	if (!SaveGame)
+	{
+		SaveGame = Cast<UTowerSaveGame>(UGameplayStatics::CreateSaveGameObject(UTowerSaveGame::StaticClass()));
+	}
+	else if (SaveGame->bHasWon)
+	{
+		// A finished tower starts over from the bottom, and the fresh save replaces the won one on disk.
+		ResetProgress();
+	}
+}
+
+UTowerSaveSubsystem* UTowerSaveSubsystem::Get(const UObject* WorldContextObject)
+{
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+	return GameInstance ? GameInstance->GetSubsystem<UTowerSaveSubsystem>() : nullptr;
+}
+
+FName UTowerSaveSubsystem::MakeSaveKey(const AActor* Actor, FName ActorSaveKey)
+{
+	const FString MapName = UWorld::RemovePIEPrefix(FPackageName::GetShortName(Actor->GetLevel()->GetOutermost()));
+	const FString ActorKey = ActorSaveKey.IsNone() ? Actor->GetName() : ActorSaveKey.ToString();
+	return FName(*FString::Printf(TEXT("%s.%s"), *MapName, *ActorKey));
+}
+
+FName UTowerSaveSubsystem::MakeSaveKey(const UOpenDoor* Door)
+{
+	return MakeSaveKey(Door->GetOwner(), Door->GetSaveKey());
+}
+
+FName UTowerSaveSubsystem::MakeSaveKey(const URotationStepComponent* StepComponent)
+{
+	return MakeSaveKey(StepComponent->GetOwner(), StepComponent->GetSaveKey());
+}
+
+void UTowerSaveSubsystem::RecordDoorState(const UOpenDoor* Door, bool bIsOpen, float Yaw)
+{
+	if (!Door || !Door->GetOwner() || !SaveGame) {return;}
+
+	FDoorSaveState& DoorState = SaveGame->DoorStates.FindOrAdd(MakeSaveKey(Door));
+	if (DoorState.bIsOpen == bIsOpen && FMath::IsNearlyEqual(DoorState.Yaw, Yaw)) {return;}
+
+	DoorState.bIsOpen = bIsOpen;
+	DoorState.Yaw = Yaw;
+	bIsDirty = true;
+}
+
+void UTowerSaveSubsystem::RecordDoorPuzzleSolved(const UOpenDoor* Door, bool bIsPuzzleSolved)
+{
+	if (!Door || !Door->GetOwner() || !SaveGame) {return;}
+
+	FDoorSaveState& DoorState = SaveGame->DoorStates.FindOrAdd(MakeSaveKey(Door));
+	if (DoorState.bIsPuzzleSolved == bIsPuzzleSolved) {return;}
+
+	DoorState.bIsPuzzleSolved = bIsPuzzleSolved;
+	bIsDirty = true;
+}
+
+void UTowerSaveSubsystem::RecordRotationStep(const URotationStepComponent* StepComponent, int32 YawStep)
+{
+	if (!StepComponent || !StepComponent->GetOwner() || !SaveGame) {return;}
+
+	const FName SaveKey = MakeSaveKey(StepComponent);
+	const int32* SavedStep = SaveGame->RotationSteps.Find(SaveKey);
+	if (SavedStep && *SavedStep == YawStep) {return;}
+
+	SaveGame->RotationSteps.Add(SaveKey, YawStep);
+	bIsDirty = true;
+}
+
+void UTowerSaveSubsystem::RecordWin()
+{
+	if (!SaveGame || SaveGame->bHasWon) {return;}
+
+	SaveGame->bHasWon = true;
+	bIsDirty = true;
+}
+
+bool UTowerSaveSubsystem::FindDoorState(const UOpenDoor* Door, FDoorSaveState& OutDoorState) const
+{
+	if (!Door || !Door->GetOwner() || !SaveGame) {return false;}
+
+	const FDoorSaveState* DoorState = SaveGame->DoorStates.Find(MakeSaveKey(Door));
+	if (!DoorState) {return false;}
+
+	OutDoorState = *DoorState;
+	return true;
+}
+
+bool UTowerSaveSubsystem::FindRotationStep(const URotationStepComponent* StepComponent, int32& OutYawStep) const
+{
+	if (!StepComponent || !StepComponent->GetOwner() || !SaveGame) {return false;}
+
+	const int32* SavedStep = SaveGame->RotationSteps.Find(MakeSaveKey(StepComponent));
+	if (!SavedStep) {return false;}
+
+	OutYawStep = *SavedStep;
+	return true;
+}
+
+void UTowerSaveSubsystem::SaveCheckpoint()
+{
+	if (!bIsDirty || !SaveGame) {return;}
+
+	// Only one save may be writing the slot at a time; remember to save again once it finishes.
+	if (bIsSaveInFlight)
+	{
+		bIsSaveQueued = true;
+		return;
+	}
+
+	bIsDirty = false;
+	bIsSaveInFlight = true;
+	UGameplayStatics::AsyncSaveGameToSlot(SaveGame, SaveSlotName, SaveUserIndex,
+		FAsyncSaveGameToSlotDelegate::CreateUObject(this, &UTowerSaveSubsystem::OnAsyncSaveFinished));
+}
+
+void UTowerSaveSubsystem::ResetProgress()
+{
+	SaveGame = Cast<UTowerSaveGame>(UGameplayStatics::CreateSaveGameObject(UTowerSaveGame::StaticClass()));
+	bIsDirty = true;
+	SaveCheckpoint();
+}
+
+void UTowerSaveSubsystem::OnAsyncSaveFinished(const FString& SlotName, const int32 UserIndex, bool bSuccess)
+{
+	bIsSaveInFlight = false;
+
+	if (!bSuccess)
+	{
+		UE_LOG(LogBuildingEscape, Error, TEXT("Failed to save tower progress to slot %s!"), *SlotName);
+		bIsDirty = true;
+	}
+
+	if (bIsSaveQueued)
+	{
+		bIsSaveQueued = false;
+		SaveCheckpoint();
+	}
+}
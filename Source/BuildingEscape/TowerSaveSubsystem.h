@@ -0,0 +1,58 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "TowerSaveGame.h"
+#include "TowerSaveSubsystem.generated.h"
+
+// Keeps the in-memory tower progress and writes it to disk asynchronously at checkpoints, only when something changed.
+UCLASS()
+class BUILDINGESCAPE_API UTowerSaveSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// Return the save subsystem of WorldContextObject's game instance, if there is one.
+	static UTowerSaveSubsystem* Get(const UObject* WorldContextObject);
+
+	// Public Functions
+	void RecordDoorState(const class UOpenDoor* Door, bool bIsOpen, float Yaw);
+	void RecordDoorPuzzleSolved(const class UOpenDoor* Door, bool bIsPuzzleSolved);
+	void RecordRotationStep(const class URotationStepComponent* StepComponent, int32 YawStep);
+	void RecordWin();
+
+	bool FindDoorState(const class UOpenDoor* Door, FDoorSaveState& OutDoorState) const;
+	bool FindRotationStep(const class URotationStepComponent* StepComponent, int32& OutYawStep) const;
+
+	// Start an async save if any state changed since the last one.
+	UFUNCTION(BlueprintCallable)
+	void SaveCheckpoint();
+
+	// Save to a different slot from now on, e.g. one per hosted session.
+	void SetSaveSlotName(const FString& NewSaveSlotName) {SaveSlotName = NewSaveSlotName;}
+
+	// Forget all progress, e.g. when starting a new game from a menu.
+	UFUNCTION(BlueprintCallable)
+	void ResetProgress();
+
+private:
+	static FName MakeSaveKey(const AActor* Actor, FName ActorSaveKey = NAME_None);
+	static FName MakeSaveKey(const class UOpenDoor* Door);
+	static FName MakeSaveKey(const class URotationStepComponent* StepComponent);
+	void OnAsyncSaveFinished(const FString& SlotName, const int32 UserIndex, bool bSuccess);
+
+	// Member Variables
+	bool bIsDirty = false;
+	bool bIsSaveInFlight = false;
+	bool bIsSaveQueued = false;
+
+	FString SaveSlotName = TEXT("TowerProgress");
+	int32 SaveUserIndex = 0;
+
+	UPROPERTY()
+	UTowerSaveGame* SaveGame = nullptr;
+};
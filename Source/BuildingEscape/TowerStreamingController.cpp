@@ -0,0 +1,121 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+
+#include "TowerStreamingController.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeGameModeBase.h"
+#include "BuildingEscapeTelemetry.h"
+#include "BuildingEscapeTowerFloors.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+
+// Sets default values
+ATowerStreamingController::ATowerStreamingController()
+{
+	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	PrimaryActorTick.bCanEverTick = true;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+}
+
+// Called when the game starts or when spawned
+void ATowerStreamingController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	for (FTowerStreamingFloor& Floor : Floors)
+	{
+		const FName PackageName = *Floor.Level.ToSoftObjectPath().GetLongPackageName();
+		Floor.StreamingLevel = UGameplayStatics::GetStreamingLevel(this, PackageName);
+		if (!Floor.StreamingLevel)
+		{
+			// Hosted sessions load sublevels under session package names; PackageNameToLoad is still the floor's.
+			ULevelStreaming* const* SessionLevel = GetWorld()->GetStreamingLevels().FindByPredicate([PackageName](const ULevelStreaming* StreamingLevel)
+			{
+				return StreamingLevel && StreamingLevel->PackageNameToLoad == PackageName;
+			});
+			Floor.StreamingLevel = SessionLevel ? *SessionLevel : nullptr;
+		}
+		if (!Floor.StreamingLevel)
+		{
+			UE_LOG(LogBuildingEscape, Error, TEXT("%s: %s is not a streaming level of this map!"), *GetName(), *PackageName.ToString());
+			continue;
+		}
+		Floor.StreamingLevel->OnLevelShown.AddDynamic(this, &ATowerStreamingController::OnFloorShown);
+	}
+
+	SetActorTickInterval(UpdateInterval);
+
+	// The player's own floor loads before the first frame so there is something to stand on.
+	UpdateStreaming(true);
+}
+
+// Called every frame
+void ATowerStreamingController::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UpdateStreaming(false);
+}
+
+int32 ATowerStreamingController::GetFloorIndexAt(float Z) const
+{
+	return BuildingEscapeTowerFloors::GetFloorIndexAt(Z, GetActorLocation().Z, Floors.Num());
+}
+
+void ATowerStreamingController::UpdateStreaming(bool bBlockOnLoad)
+{
+	APawn* PlayerPawn = ABuildingEscapeGameModeBase::GetTowerPlayer(this);
+	if (!PlayerPawn) {return;}
+
+	const int32 PlayerFloor = GetFloorIndexAt(PlayerPawn->GetActorLocation().Z);
+	if (PlayerFloor == INDEX_NONE) {return;}
+
+	for (int32 i = 0; i < Floors.Num(); i++)
+	{
+		const ULevelStreaming* StreamingLevel = Floors[i].StreamingLevel;
+		if (!StreamingLevel) {continue;}
+
+		const bool bShouldBeLoaded = BuildingEscapeTowerFloors::ShouldBeResident(i, PlayerFloor, StreamingLevel->ShouldBeLoaded());
+
+		// The player's floor streams first, then the closest floors.
+		Floors[i].StreamingLevel->SetPriority(BuildingEscapeLoadPriority::PlayerFloor - FMath::Abs(i - PlayerFloor));
+		SetFloorLoaded(i, bShouldBeLoaded, bBlockOnLoad && i == PlayerFloor);
+	}
+}
+
+void ATowerStreamingController::SetFloorLoaded(int32 FloorIndex, bool bShouldBeLoaded, bool bBlockOnLoad)
+{
+	FTowerStreamingFloor& Floor = Floors[FloorIndex];
+	ULevelStreaming* StreamingLevel = Floor.StreamingLevel;
+	if (StreamingLevel->ShouldBeLoaded() == bShouldBeLoaded) {return;}
+
+	UE_LOG(LogBuildingEscape, Log, TEXT("Streaming %s floor %d (%s)."), bShouldBeLoaded ? TEXT("in") : TEXT("out"), FloorIndex, *StreamingLevel->GetWorldAssetPackageName());
+	Floor.LoadRequestTime = bShouldBeLoaded ? FPlatformTime::Seconds() : 0.0;
+
+	StreamingLevel->bShouldBlockOnLoad = bBlockOnLoad;
+	StreamingLevel->SetShouldBeLoaded(bShouldBeLoaded);
+	StreamingLevel->SetShouldBeVisible(bShouldBeLoaded);
+	if (bBlockOnLoad)
+	{
+		GetWorld()->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+	}
+}
+
+void ATowerStreamingController::OnFloorShown()
+{
+	// OnLevelShown does not say which level, so check every floor waiting to be shown.
+	for (int32 i = 0; i < Floors.Num(); i++)
+	{
+		FTowerStreamingFloor& Floor = Floors[i];
+		if (Floor.LoadRequestTime == 0.0 || !Floor.StreamingLevel || !Floor.StreamingLevel->IsLevelVisible()) {continue;}
+
+		const float LoadSeconds = FPlatformTime::Seconds() - Floor.LoadRequestTime;
+		UE_LOG(LogBuildingEscape, Log, TEXT("Floor %d shown %.3f s after it was requested."), i, LoadSeconds);
+		BuildingEscapeTelemetry::RecordLevelLoad(Floor.StreamingLevel->GetWorldAssetPackageName(), LoadSeconds);
+		Floor.LoadRequestTime = 0.0;
+	}
+}
@@ -0,0 +1,71 @@
+// Copyright Andrew Woodworth 2019-2020 All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TowerStreamingController.generated.h"
+
+class ULevelStreaming;
+
+USTRUCT()
+struct FTowerStreamingFloor
+{
+	GENERATED_USTRUCT_BODY()
+
+
+	// Streaming sublevel holding this floor's actors. Must be in the persistent level's Levels list.
+	UPROPERTY(EditAnyWhere)
+	TSoftObjectPtr<UWorld> Level;
+
+	UPROPERTY()
+	ULevelStreaming* StreamingLevel;
+
+	double LoadRequestTime;
+
+	// Default constructor.
+	FTowerStreamingFloor()
+	{
+		StreamingLevel = nullptr;
+		LoadRequestTime = 0.0;
+	}
+};
+
+// Streams the tower's per-floor sublevels around the player: floors inside the BuildingEscapeTowerFloors window are
+// loaded and made visible asynchronously, and floors outside it are unloaded. Floors[0] is the floor starting at the
+// controller's height, with each next floor TowerFloorHeight above the last.
+// Doors and rotatable actors record their state in the tower save as their floor unloads and restore it on reload.
+UCLASS()
+class BUILDINGESCAPE_API ATowerStreamingController : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	ATowerStreamingController();
+
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+	// Return the floor the given height is on, clamped to the tower.
+	int32 GetFloorIndexAt(float Z) const;
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+private:
+	void UpdateStreaming(bool bBlockOnLoad);
+	void SetFloorLoaded(int32 FloorIndex, bool bShouldBeLoaded, bool bBlockOnLoad);
+
+	UFUNCTION()
+	void OnFloorShown();
+
+	// Member Variables
+	UPROPERTY(EditAnyWhere, Category = "Streaming")
+	TArray<FTowerStreamingFloor> Floors;
+
+	// Seconds between streaming updates.
+	UPROPERTY(EditAnyWhere, Category = "Streaming", meta = (ClampMin = "0"))
+	float UpdateInterval = 0.25f;
+};
@@ -2,12 +2,16 @@
 
 
 #include "WinGameComponent.h"
+#include "AutoplaySubsystem.h"
+#include "BuildingEscape.h"
+#include "BuildingEscapeGameModeBase.h"
 #include "Blueprint/UserWidget.h"
 #include "Engine/World.h"
 #include "GameFramework/Actor.h"
 #include "Math/Color.h"
 #include "Kismet/GameplayStatics.h"
 #include "TimerManager.h"
+#include "TowerSaveSubsystem.h"
 
 // Sets default values for this component's properties
 UWinGameComponent::UWinGameComponent()
@@ -25,7 +29,7 @@ void UWinGameComponent::BeginPlay()
 
 	if (!ActorThatWins)
 	{
-		ActorThatWins = GetWorld()->GetFirstPlayerController()->GetPawn();
+		ActorThatWins = ABuildingEscapeGameModeBase::GetTowerPlayer(this);
 	}
 
 	CheckForWinGameTriggerVolume();
@@ -35,7 +39,7 @@ void UWinGameComponent::CheckForWinGameTriggerVolume() const
 {
 	if (!WinGameTriggerVolume)
 	{
-		UE_LOG(LogTemp, Error, TEXT("%s has a WinGameComponent attached but no Win Game Trigger Volume set!"), *GetOwner()->GetName());
+		UE_LOG(LogBuildingEscape, Error, TEXT("%s has a WinGameComponent attached but no Win Game Trigger Volume set!"), *GetOwner()->GetName());
 	}
 }
 
@@ -47,6 +51,17 @@ void UWinGameComponent::TickComponent(float DeltaTime, ELevelTick TickType, FAct
 	if (WinGameTriggerVolume->IsOverlappingActor(ActorThatWins) && bCanLoadWinLevel)
 	{
 		bCanLoadWinLevel = false;
+
+		if (UTowerSaveSubsystem* TowerSave = UTowerSaveSubsystem::Get(this))
+		{
+			TowerSave->RecordWin();
+			TowerSave->SaveCheckpoint();
+		}
+
+		// The simulation host restarts hosted sessions itself; opening the win level would race that restart.
+		UAutoplaySubsystem* Autoplay = UAutoplaySubsystem::Get(this);
+		if (Autoplay && Autoplay->IsHostedSession()) {return;}
+
 		UGameplayStatics::GetPlayerCameraManager(GetWorld(), 0)->StartCameraFade(0.f, 1.f, 2.f, FLinearColor(0.f, 0.f, 0.f, 1.f), false, true);
 		GetWorld()->GetTimerManager().SetTimer(FadeScreenTimerHandle, this, &UWinGameComponent::LoadWinLevel, 2.f, false);
 	}